@@ -0,0 +1,224 @@
+#include <macro.hpp>
+
+import std;
+import gal.utility;
+import gal.image;
+
+// Usage: G-benchmark-image-loader [corpus directory] [file count] [width] [height] [synchronous|pipeline|both]
+// The corpus is generated on the first run and reused afterwards.
+// Both modes read the same files, so the second pass of `both` (the pipeline) reads them from a page cache warmed by the first one.
+// For a fair cold cache comparison, run `synchronous` and `pipeline` in separate processes and drop the page cache before each of them
+// (e.g. `sync; echo 3 > /proc/sys/vm/drop_caches` on Linux), otherwise only the decode / convert / resize work is compared.
+
+namespace
+{
+	using namespace gal::gui;
+
+	using pipeline_type = image::LoadPipeline<std::uint8_t, std::uint32_t>;
+	using pixmap_type	= pipeline_type::pixmap_type;
+	using decoded_type	= pipeline_type::decoded_pixmap_type;
+	using clock_type	= std::chrono::steady_clock;
+	using duration_type = std::chrono::duration<double, std::milli>;
+
+	constexpr std::size_t thumbnail_size = 64;
+
+	// width(u32) height(u32) pixels(RGBA8 * width * height)
+	auto generate_corpus(const std::filesystem::path& directory, const std::size_t count, const std::uint32_t width, const std::uint32_t height) -> std::vector<std::filesystem::path>
+	{
+		std::filesystem::create_directories(directory);
+
+		std::vector<std::uint32_t> pixels(static_cast<std::size_t>(width) * height);
+		std::mt19937			   random{42};
+
+		std::vector<std::filesystem::path> paths;
+		paths.reserve(count);
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			auto path = directory / std::format("{:04d}_{}x{}.raw", i, width, height);
+			if (not std::filesystem::exists(path))
+			{
+				std::ranges::generate(pixels, std::ref(random));
+
+				std::ofstream file{path, std::ios::binary};
+				file.write(reinterpret_cast<const char*>(&width), sizeof(width));
+				file.write(reinterpret_cast<const char*>(&height), sizeof(height));
+				file.write(reinterpret_cast<const char*>(pixels.data()), static_cast<std::streamsize>(pixels.size() * sizeof(std::uint32_t)));
+			}
+			paths.push_back(std::move(path));
+		}
+		return paths;
+	}
+
+	[[nodiscard]] auto decode(const std::span<const std::byte> bytes) -> decoded_type
+	{
+		std::uint32_t width;
+		std::uint32_t height;
+		std::memcpy(&width, bytes.data(), sizeof(width));
+		std::memcpy(&height, bytes.data() + sizeof(width), sizeof(height));
+
+		if (bytes.size() != sizeof(width) + sizeof(height) + static_cast<std::size_t>(width) * height * sizeof(std::uint32_t))
+		{
+			throw utility::make_exception("Corrupted image!");
+		}
+
+		decoded_type result{width, height};
+		std::memcpy(result.data(), bytes.data() + sizeof(width) + sizeof(height), result.size() * sizeof(std::uint32_t));
+		return result;
+	}
+
+	[[nodiscard]] auto luminance(const std::uint32_t& rgba) -> std::uint8_t
+	{
+		const auto r = (rgba >> 0) & 0xff;
+		const auto g = (rgba >> 8) & 0xff;
+		const auto b = (rgba >> 16) & 0xff;
+		return static_cast<std::uint8_t>((r * 54 + g * 183 + b * 19) >> 8);
+	}
+
+	auto report(const std::string_view name, const duration_type total, std::vector<duration_type> latencies) -> void
+	{
+		std::ranges::sort(latencies);
+
+		const auto percentile = [&latencies](const double p) -> double
+		{
+			const auto index = static_cast<std::size_t>(p * static_cast<double>(latencies.size() - 1));
+			return latencies[index].count();
+		};
+
+		std::cout << std::format(
+				"{:<12} total {:>9.2f} ms | {:>8.1f} files/s | latency p50 {:>8.2f} ms p90 {:>8.2f} ms p99 {:>8.2f} ms max {:>8.2f} ms\n",
+				name,
+				total.count(),
+				static_cast<double>(latencies.size()) / (total.count() / 1000),
+				percentile(.5),
+				percentile(.9),
+				percentile(.99),
+				latencies.back().count());
+	}
+
+	// read -> decode -> convert -> resize, one file after another on the calling thread.
+	auto run_synchronous(const std::vector<std::filesystem::path>& paths) -> void
+	{
+		std::vector<duration_type> latencies;
+		latencies.reserve(paths.size());
+
+		const auto begin = clock_type::now();
+		for (const auto& path: paths)
+		{
+			const auto			   start = clock_type::now();
+
+			std::ifstream		   file{path, std::ios::binary};
+			std::vector<std::byte> bytes(static_cast<std::size_t>(std::filesystem::file_size(path)));
+			file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+			const auto decoded = decode(bytes);
+			pixmap_type converted{decoded.width(), decoded.height()};
+			image::convert(image::PixmapView<const std::uint32_t>{decoded}, image::PixmapView<std::uint8_t>{converted}, luminance);
+			pixmap_type thumbnail{thumbnail_size, thumbnail_size};
+			image::resize_nearest(image::PixmapView<const std::uint8_t>{converted}, image::PixmapView<std::uint8_t>{thumbnail});
+
+			latencies.emplace_back(clock_type::now() - start);
+		}
+		report("synchronous", clock_type::now() - begin, std::move(latencies));
+	}
+
+	auto run_pipeline(const std::vector<std::filesystem::path>& paths) -> void
+	{
+		pipeline_type							  pipeline{decode, luminance};
+
+		std::vector<clock_type::time_point>		  starts(paths.size());
+		std::vector<duration_type>				  latencies(paths.size());
+		std::vector<std::exception_ptr>			  errors(paths.size());
+		std::atomic<std::size_t>				  remaining{paths.size()};
+
+		const auto								  begin = clock_type::now();
+		for (std::size_t i = 0; i < paths.size(); ++i)
+		{
+			starts[i] = clock_type::now();
+			pipeline.load(paths[i], {.priority = image::LoadPriority::normal, .width = thumbnail_size, .height = thumbnail_size})
+					.then(
+							[&, i](pipeline_type::result_type result) noexcept
+							{
+								// The callback runs on a worker thread, the failures are reported once all loads are complete.
+								if (not result.has_value())
+								{
+									errors[i] = std::move(result.error());
+								}
+
+								latencies[i] = clock_type::now() - starts[i];
+								if (remaining.fetch_sub(1) == 1)
+								{
+									remaining.notify_all();
+								}
+							});
+		}
+
+		for (auto current = remaining.load(); current != 0; current = remaining.load())
+		{
+			remaining.wait(current);
+		}
+		const auto total = clock_type::now() - begin;
+
+		std::size_t failures{0};
+		for (std::size_t i = 0; i < paths.size(); ++i)
+		{
+			if (not errors[i])
+			{
+				continue;
+			}
+
+			try
+			{
+				std::rethrow_exception(errors[i]);
+			}
+			catch (const std::exception& exception)
+			{
+				std::cerr << std::format("failed to load `{}`: {}\n", paths[i].string(), exception.what());
+			}
+			++failures;
+		}
+		if (failures != 0)
+		{
+			std::cerr << std::format("{} of {} loads failed, their latencies are included\n", failures, paths.size());
+		}
+
+		// Latencies include the time spent waiting for a free slot (backpressure).
+		report("pipeline", total, std::move(latencies));
+	}
+}// namespace
+
+auto main(const int argc, const char* argv[]) -> int
+{
+	const std::filesystem::path directory = argc > 1 ? std::filesystem::path{argv[1]} : std::filesystem::temp_directory_path() / "gal_benchmark_image_loader";
+	const std::size_t			count	  = argc > 2 ? std::stoull(argv[2]) : 500;
+	const auto					width	  = static_cast<std::uint32_t>(argc > 3 ? std::stoul(argv[3]) : 512);
+	const auto					height	  = static_cast<std::uint32_t>(argc > 4 ? std::stoul(argv[4]) : 512);
+	const std::string_view		mode	  = argc > 5 ? argv[5] : "both";
+
+	if (count == 0)
+	{
+		std::cerr << "file count must be at least 1\n";
+		return 1;
+	}
+	if (mode != "synchronous" and mode != "pipeline" and mode != "both")
+	{
+		std::cerr << std::format("unknown mode `{}`, expected synchronous, pipeline or both\n", mode);
+		return 1;
+	}
+
+	const auto paths = generate_corpus(directory, count, width, height);
+
+	std::cout << std::format("corpus: {} ({} files of {}x{}), mode: {}\n", directory.string(), count, width, height, mode);
+
+	if (mode != "pipeline")
+	{
+		run_synchronous(paths);
+	}
+	if (mode != "synchronous")
+	{
+		if (mode == "both")
+		{
+			std::cout << "the pipeline pass reads the files from the page cache warmed by the synchronous pass\n";
+		}
+		run_pipeline(paths);
+	}
+}
@@ -0,0 +1,155 @@
+#include <macro.hpp>
+
+import std;
+import gal.utility;
+import gal.image;
+
+// Usage: G-benchmark-image-rasterizer [paths] [iterations]
+
+namespace
+{
+	using namespace gal::gui;
+
+	using clock_type	= std::chrono::steady_clock;
+	using duration_type = std::chrono::duration<double, std::milli>;
+
+	constexpr std::size_t atlas_size{2048};
+
+	// 4 cubics per circle
+	constexpr float		  circle_kappa{0.5522847f};
+
+	auto add_rounded_rect(image::Path& path, const float x, const float y, const float width, const float height, const float radius) -> void
+	{
+		const auto k = radius * (1 - circle_kappa);
+
+		path.move_to({x + radius, y});
+		path.line_to({x + width - radius, y});
+		path.cubic_to({x + width - k, y}, {x + width, y + k}, {x + width, y + radius});
+		path.line_to({x + width, y + height - radius});
+		path.cubic_to({x + width, y + height - k}, {x + width - k, y + height}, {x + width - radius, y + height});
+		path.line_to({x + radius, y + height});
+		path.cubic_to({x + k, y + height}, {x, y + height - k}, {x, y + height - radius});
+		path.line_to({x, y + radius});
+		path.cubic_to({x, y + k}, {x + k, y}, {x + radius, y});
+		path.close();
+	}
+
+	auto add_ring(image::Path& path, const float center_x, const float center_y, const float radius) -> void
+	{
+		// outer circle, then the inner one in the same direction: a ring with even-odd, a disc with nonzero
+		for (const auto r: {radius, radius / 2})
+		{
+			const auto k = r * circle_kappa;
+
+			path.move_to({center_x + r, center_y});
+			path.cubic_to({center_x + r, center_y + k}, {center_x + k, center_y + r}, {center_x, center_y + r});
+			path.cubic_to({center_x - k, center_y + r}, {center_x - r, center_y + k}, {center_x - r, center_y});
+			path.cubic_to({center_x - r, center_y - k}, {center_x - k, center_y - r}, {center_x, center_y - r});
+			path.cubic_to({center_x + k, center_y - r}, {center_x + r, center_y - k}, {center_x + r, center_y});
+			path.close();
+		}
+	}
+
+	struct Shape
+	{
+		float x;
+		float y;
+		float size;
+	};
+
+	template<typename Function>
+	[[nodiscard]] auto measure(const std::size_t iterations, Function function) -> duration_type
+	{
+		// warm up
+		function();
+
+		auto best = duration_type::max();
+		for (std::size_t i = 0; i < iterations; ++i)
+		{
+			const auto begin = clock_type::now();
+			function();
+			best = std::ranges::min(best, duration_type{clock_type::now() - begin});
+		}
+		return best;
+	}
+}// namespace
+
+auto main(const int argc, const char* argv[]) -> int
+{
+	const std::size_t paths		 = argc > 1 ? std::stoull(argv[1]) : 10000;
+	const std::size_t iterations = argc > 2 ? std::stoull(argv[2]) : 5;
+
+	std::mt19937	  random{42};
+
+	for (const auto size: {8.f, 16.f, 32.f, 64.f})
+	{
+		std::uniform_real_distribution<float> position{0, static_cast<float>(atlas_size) - size};
+
+		std::vector<Shape>					  shapes(paths);
+		std::ranges::generate(shapes, [&] { return Shape{position(random), position(random), size}; });
+
+		image::Pixmap<std::uint8_t, std::allocator<std::uint8_t>> atlas{atlas_size, atlas_size};
+		const image::PixmapView<std::uint8_t>					  atlas_view{atlas};
+
+		image::Path												  path;
+		image::Rasterizer										  rasterizer;
+
+		const auto												  report = [&](const std::string_view name, const duration_type duration)
+		{
+			std::cout << std::format(
+					"{:>3}px {:<28} {:>9.3f} ms {:>9.1f} ns/path\n",
+					size,
+					name,
+					duration.count(),
+					duration.count() * 1e6 / static_cast<double>(paths));
+		};
+
+		report(
+				"rounded rect (nonzero)",
+				measure(
+						iterations,
+						[&]
+						{
+							for (const auto [x, y, s]: shapes)
+							{
+								path.clear();
+								add_rounded_rect(path, x, y, s, s * .75f, s / 4);
+								rasterizer.fill(path, atlas_view);
+							}
+						}));
+
+		report(
+				"ring (even-odd)",
+				measure(
+						iterations,
+						[&]
+						{
+							for (const auto [x, y, s]: shapes)
+							{
+								path.clear();
+								add_ring(path, x + s / 2, y + s / 2, s / 2);
+								rasterizer.fill(path, atlas_view, image::FillRule::even_odd);
+							}
+						}));
+
+		// the same paths flattened once, only the rasterization is measured
+		std::vector<image::Path> flattened(paths);
+		for (std::size_t i = 0; i < paths; ++i)
+		{
+			add_rounded_rect(flattened[i], shapes[i].x, shapes[i].y, shapes[i].size, shapes[i].size * .75f, shapes[i].size / 4);
+		}
+		report(
+				"rounded rect (prebuilt path)",
+				measure(
+						iterations,
+						[&]
+						{
+							for (const auto& each: flattened)
+							{
+								rasterizer.fill(each, atlas_view);
+							}
+						}));
+
+		std::cout << '\n';
+	}
+}
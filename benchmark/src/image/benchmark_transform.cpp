@@ -0,0 +1,110 @@
+#include <macro.hpp>
+
+import std;
+import gal.utility;
+import gal.image;
+
+// Usage: G-benchmark-image-transform [iterations]
+
+namespace
+{
+	using namespace gal::gui;
+
+	using clock_type	= std::chrono::steady_clock;
+	using duration_type = std::chrono::duration<double, std::milli>;
+
+	template<typename T>
+	auto naive_transpose(const image::PixmapView<const T> source, image::PixmapView<T> dest) -> void
+	{
+		for (std::size_t y = 0; y < source.height(); ++y)
+		{
+			for (std::size_t x = 0; x < source.width(); ++x)
+			{
+				dest.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(y, x) = source.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(x, y);
+			}
+		}
+	}
+
+	template<typename T>
+	auto naive_rotate_90(const image::PixmapView<const T> source, image::PixmapView<T> dest) -> void
+	{
+		for (std::size_t y = 0; y < source.height(); ++y)
+		{
+			for (std::size_t x = 0; x < source.width(); ++x)
+			{
+				dest.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(source.height() - 1 - y, x) = source.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(x, y);
+			}
+		}
+	}
+
+	template<typename Function>
+	[[nodiscard]] auto measure(const std::size_t iterations, Function function) -> duration_type
+	{
+		// warm up
+		function();
+
+		auto best = duration_type::max();
+		for (std::size_t i = 0; i < iterations; ++i)
+		{
+			const auto begin = clock_type::now();
+			function();
+			best = std::ranges::min(best, duration_type{clock_type::now() - begin});
+		}
+		return best;
+	}
+
+	template<typename T>
+	auto run(const std::size_t width, const std::size_t height, const std::size_t iterations) -> void
+	{
+		image::Pixmap<T, std::allocator<T>> source{width, height};
+		image::Pixmap<T, std::allocator<T>> dest{height, width};
+
+		std::mt19937						random{42};
+		std::ranges::generate(source, [&random] { return static_cast<T>(random()); });
+
+		const image::PixmapView<const T> source_view{source};
+		const image::PixmapView<T>		 dest_view{dest};
+
+		const auto						 report = [&](const std::string_view name, const duration_type duration)
+		{
+			// read + write
+			const auto bytes = static_cast<double>(2 * source.size() * sizeof(T));
+			std::cout << std::format(
+					"{:>5}x{:<5} {}B {:<18} {:>9.3f} ms {:>8.2f} GB/s\n",
+					width,
+					height,
+					sizeof(T),
+					name,
+					duration.count(),
+					bytes / (duration.count() / 1000) / 1e9);
+		};
+
+		report("transpose (naive)", measure(iterations, [&] { naive_transpose(source_view, dest_view); }));
+		report("transpose", measure(iterations, [&] { image::transpose(source_view, dest_view); }));
+		report("rotate_90 (naive)", measure(iterations, [&] { naive_rotate_90(source_view, dest_view); }));
+		report("rotate_90", measure(iterations, [&] { image::rotate_90(source_view, dest_view); }));
+
+		image::Pixmap<T, std::allocator<T>> same{width, height};
+		const image::PixmapView<T>			same_view{same};
+		report("rotate_180", measure(iterations, [&] { image::rotate_180(source_view, same_view); }));
+		report("flip_vertical", measure(iterations, [&] { image::flip_vertical(same_view); }));
+		report("flip_horizontal", measure(iterations, [&] { image::flip_horizontal(same_view); }));
+	}
+}// namespace
+
+auto main(const int argc, const char* argv[]) -> int
+{
+	const std::size_t iterations = argc > 1 ? std::stoull(argv[1]) : 5;
+
+	// The power of two sizes are the worst case of the naive version: every column write maps to the same cache set.
+	constexpr std::array<std::pair<std::size_t, std::size_t>, 5> sizes{{{256, 256}, {1000, 1000}, {1024, 1024}, {1920, 1080}, {4096, 4096}}};
+
+	for (const auto [width, height]: sizes)
+	{
+		run<std::uint8_t>(width, height, iterations);
+		run<std::uint16_t>(width, height, iterations);
+		run<std::uint32_t>(width, height, iterations);
+		run<std::uint64_t>(width, height, iterations);
+		std::cout << '\n';
+	}
+}
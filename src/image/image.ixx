@@ -3,3 +3,9 @@ module;
 export module gal.image;
 
 export import :pixmap;
+export import :loader;
+export import :reduction;
+export import :transform;
+export import :summed_area_table;
+export import :mip_pyramid;
+export import :rasterizer;
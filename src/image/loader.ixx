@@ -0,0 +1,769 @@
+module;
+
+#include <macro.hpp>
+
+export module gal.image:loader;
+
+import std;
+import gal.utility;
+import :pixmap;
+
+export namespace gal::gui::image
+{
+	enum class LoadPriority : std::uint8_t
+	{
+		low,
+		normal,
+		high,
+	};
+
+	class LoadCancelled : public utility::Exception
+	{
+	public:
+		using Exception::Exception;
+	};
+
+	/**
+	 * @brief Converts each pixel of source into the pixel of dest at the same position.
+	 * @note Both views must have the same size, the strides may differ.
+	 */
+	template<typename S, typename T, std::invocable<const S&> Converter>
+		requires std::is_convertible_v<std::invoke_result_t<Converter&, const S&>, T>
+	constexpr auto convert(const PixmapView<const S> source, PixmapView<T> dest, Converter converter) noexcept(std::is_nothrow_invocable_v<Converter&, const S&>) -> void
+	{
+		GAL_ASSUME(source.width() == dest.width(), "Width mismatch!");
+		GAL_ASSUME(source.height() == dest.height(), "Height mismatch!");
+
+		for (typename PixmapView<T>::size_type y = 0; y < source.height(); ++y)
+		{
+			std::ranges::transform(source[y], dest[y].begin(), std::ref(converter));
+		}
+	}
+
+	/**
+	 * @brief Resamples source into dest with nearest-neighbor sampling.
+	 * @note The source column of every dest column is computed once and shared by all rows.
+	 */
+	template<typename T>
+	constexpr auto resize_nearest(const PixmapView<const T> source, PixmapView<T> dest) noexcept(false) -> void
+	{
+		using size_type = typename PixmapView<T>::size_type;
+
+		if (dest.empty())
+		{
+			return;
+		}
+
+		GAL_ASSUME(not source.empty(), "Cannot resize an empty pixmap!");
+
+		std::vector<size_type> columns(dest.width());
+		for (size_type x = 0; x < dest.width(); ++x)
+		{
+			columns[x] = x * source.width() / dest.width();
+		}
+
+		for (size_type y = 0; y < dest.height(); ++y)
+		{
+			const auto source_row = source[y * source.height() / dest.height()];
+			auto	   dest_row	  = dest[y];
+
+			for (size_type x = 0; x < dest.width(); ++x)
+			{
+				dest_row[x] = source_row[columns[x]];
+			}
+		}
+	}
+
+	/**
+	 * @brief A fixed number of worker threads that resume coroutines, higher priority first and FIFO within the same priority.
+	 */
+	class WorkerPool
+	{
+	public:
+		using size_type = std::size_t;
+
+	private:
+		struct Job
+		{
+			LoadPriority			priority;
+			std::uint64_t			sequence;
+			std::coroutine_handle<> handle;
+
+			[[nodiscard]] constexpr auto operator<(const Job& other) const noexcept -> bool
+			{
+				// std::priority_queue pops the greatest element.
+				if (priority != other.priority)
+				{
+					return priority < other.priority;
+				}
+				return sequence > other.sequence;
+			}
+		};
+
+		class ScheduleAwaiter
+		{
+			WorkerPool&	 pool_;
+			LoadPriority priority_;
+
+		public:
+			constexpr ScheduleAwaiter(WorkerPool& pool, const LoadPriority priority) noexcept
+				: pool_{pool},
+				  priority_{priority} {}
+
+			[[nodiscard]] constexpr auto await_ready() const noexcept -> bool
+			{
+				return false;
+			}
+
+			auto await_suspend(const std::coroutine_handle<> handle) noexcept(false) -> void
+			{
+				pool_.post(priority_, handle);
+			}
+
+			constexpr auto await_resume() const noexcept -> void {}
+		};
+
+		// The pool whose job is running on the current thread, if any.
+		inline static thread_local const WorkerPool* current_ = nullptr;
+
+		std::mutex									 mutex_;
+		std::condition_variable_any					 condition_;
+		std::priority_queue<Job>					 jobs_;
+		std::uint64_t								 sequence_;
+		std::vector<std::jthread>					 workers_;
+
+		auto work(const std::stop_token token) noexcept -> void
+		{
+			current_ = this;
+
+			while (true)
+			{
+				std::coroutine_handle<> handle;
+				{
+					std::unique_lock lock{mutex_};
+					// Jobs that were queued before the stop request are still drained, so no coroutine is left suspended forever.
+					condition_.wait(lock, token, [this] { return not jobs_.empty(); });
+					if (jobs_.empty())
+					{
+						return;
+					}
+
+					handle = jobs_.top().handle;
+					jobs_.pop();
+				}
+
+				handle.resume();
+			}
+		}
+
+	public:
+		WorkerPool(const WorkerPool&)					 = delete;
+		WorkerPool(WorkerPool&&)						 = delete;
+		auto operator=(const WorkerPool&) -> WorkerPool& = delete;
+		auto operator=(WorkerPool&&) -> WorkerPool&		 = delete;
+
+		explicit WorkerPool(const size_type threads) noexcept(false)
+			: sequence_{0}
+		{
+			GAL_ASSUME(threads != 0, "A worker pool requires at least one thread!");
+
+			workers_.reserve(threads);
+			for (size_type i = 0; i < threads; ++i)
+			{
+				workers_.emplace_back([this](const std::stop_token token) { work(token); });
+			}
+		}
+
+		~WorkerPool() noexcept
+		{
+			for (auto& worker: workers_)
+			{
+				worker.request_stop();
+			}
+			// join
+			workers_.clear();
+		}
+
+		[[nodiscard]] auto size() const noexcept -> size_type
+		{
+			return workers_.size();
+		}
+
+		/**
+		 * @brief Returns true if the calling thread is one of the workers of this pool.
+		 */
+		[[nodiscard]] auto is_worker_thread() const noexcept -> bool
+		{
+			return current_ == this;
+		}
+
+		/**
+		 * @brief Resumes handle on one of the workers.
+		 */
+		auto post(const LoadPriority priority, const std::coroutine_handle<> handle) noexcept(false) -> void
+		{
+			{
+				std::scoped_lock lock{mutex_};
+				jobs_.push({.priority = priority, .sequence = sequence_++, .handle = handle});
+			}
+			condition_.notify_one();
+		}
+
+		/**
+		 * @brief co_await pool.schedule(priority) suspends the current coroutine and resumes it on one of the workers.
+		 */
+		[[nodiscard]] auto schedule(const LoadPriority priority = LoadPriority::normal) noexcept -> ScheduleAwaiter
+		{
+			return {*this, priority};
+		}
+	};
+
+	template<typename T, typename Allocator = std::allocator<T>>
+	class LoadState
+	{
+	public:
+		using pixmap_type	= Pixmap<T, Allocator>;
+		using result_type	= std::expected<pixmap_type, std::exception_ptr>;
+		// Invoked on a worker thread, where an exception would have nowhere to go.
+		using callback_type = std::move_only_function<void(result_type) noexcept>;
+
+	private:
+		mutable std::mutex				mutex_;
+		mutable std::condition_variable condition_;
+		std::optional<result_type>		result_;
+		std::coroutine_handle<>			continuation_;
+		callback_type					callback_;
+		std::stop_source				stop_source_;
+		LoadPriority					priority_;
+
+		[[nodiscard]] auto take() noexcept(false) -> pixmap_type
+		{
+			auto result = std::move(*result_);
+			if (not result.has_value())
+			{
+				std::rethrow_exception(result.error());
+			}
+			return std::move(*result);
+		}
+
+	public:
+		class Awaiter
+		{
+			LoadState& state_;
+
+		public:
+			constexpr explicit Awaiter(LoadState& state) noexcept
+				: state_{state} {}
+
+			[[nodiscard]] auto await_ready() const noexcept -> bool
+			{
+				return state_.ready();
+			}
+
+			[[nodiscard]] auto await_suspend(const std::coroutine_handle<> handle) noexcept -> bool
+			{
+				std::scoped_lock lock{state_.mutex_};
+				if (state_.result_.has_value())
+				{
+					return false;
+				}
+
+				state_.continuation_ = handle;
+				return true;
+			}
+
+			[[nodiscard]] auto await_resume() noexcept(false) -> pixmap_type
+			{
+				return state_.take();
+			}
+		};
+
+		explicit LoadState(const LoadPriority priority) noexcept
+			: priority_{priority} {}
+
+		[[nodiscard]] auto priority() const noexcept -> LoadPriority
+		{
+			return priority_;
+		}
+
+		[[nodiscard]] auto ready() const noexcept -> bool
+		{
+			std::scoped_lock lock{mutex_};
+			return result_.has_value();
+		}
+
+		[[nodiscard]] auto stop_requested() const noexcept -> bool
+		{
+			return stop_source_.stop_requested();
+		}
+
+		auto cancel() noexcept -> void
+		{
+			stop_source_.request_stop();
+		}
+
+		auto wait() const noexcept -> void
+		{
+			std::unique_lock lock{mutex_};
+			condition_.wait(lock, [this] { return result_.has_value(); });
+		}
+
+		[[nodiscard]] auto get() noexcept(false) -> pixmap_type
+		{
+			wait();
+			return take();
+		}
+
+		auto then(callback_type callback) noexcept(false) -> void
+		{
+			{
+				std::scoped_lock lock{mutex_};
+				if (not result_.has_value())
+				{
+					callback_ = std::move(callback);
+					return;
+				}
+			}
+
+			callback(std::move(*result_));
+		}
+
+		/**
+		 * @note The continuation is resumed inline, its promise must not rethrow from unhandled_exception.
+		 */
+		auto complete(result_type result) noexcept -> void
+		{
+			std::coroutine_handle<> continuation;
+			callback_type			callback;
+			{
+				std::scoped_lock lock{mutex_};
+				result_.emplace(std::move(result));
+				continuation = std::exchange(continuation_, nullptr);
+				callback	 = std::exchange(callback_, nullptr);
+			}
+			condition_.notify_all();
+
+			if (callback)
+			{
+				callback(std::move(*result_));
+			}
+			else if (continuation)
+			{
+				continuation.resume();
+			}
+		}
+	};
+
+	/**
+	 * @brief The result of LoadPipeline::load, the pixmap can be retrieved with exactly one of get / then / co_await.
+	 */
+	template<typename T, typename Allocator = std::allocator<T>>
+	class LoadHandle
+	{
+	public:
+		using state_type	= LoadState<T, Allocator>;
+		using pixmap_type	= typename state_type::pixmap_type;
+		using result_type	= typename state_type::result_type;
+		using callback_type = typename state_type::callback_type;
+
+	private:
+		std::shared_ptr<state_type> state_;
+
+	public:
+		explicit LoadHandle(std::shared_ptr<state_type> state) noexcept
+			: state_{std::move(state)} {}
+
+		[[nodiscard]] auto ready() const noexcept -> bool
+		{
+			return state_->ready();
+		}
+
+		/**
+		 * @brief Requests the cancellation, the loading stops before the next stage starts and reports LoadCancelled.
+		 */
+		auto cancel() const noexcept -> void
+		{
+			state_->cancel();
+		}
+
+		auto wait() const noexcept -> void
+		{
+			state_->wait();
+		}
+
+		/**
+		 * @brief Blocks until the loading is complete.
+		 * @throw LoadCancelled if the loading was cancelled, or any exception thrown by one of the stages.
+		 */
+		[[nodiscard]] auto get() const noexcept(false) -> pixmap_type
+		{
+			return state_->get();
+		}
+
+		/**
+		 * @brief Invokes callback on the worker thread that completes the loading, or immediately if it is already complete.
+		 * @note The callback must be noexcept, a failed load is reported through the error of the result instead.
+		 */
+		auto then(callback_type callback) const noexcept(false) -> void
+		{
+			state_->then(std::move(callback));
+		}
+
+		/**
+		 * @brief The awaiting coroutine is resumed on the worker thread that completes the loading.
+		 * @note An exception escaping the resumed coroutine (its promise rethrowing from unhandled_exception) terminates.
+		 */
+		[[nodiscard]] auto operator co_await() const noexcept -> typename state_type::Awaiter
+		{
+			return typename state_type::Awaiter{*state_};
+		}
+	};
+
+	struct LoadRequest
+	{
+		LoadPriority priority = LoadPriority::normal;
+		// 0 keeps the decoded size.
+		std::size_t	 width	  = 0;
+		std::size_t	 height	  = 0;
+	};
+
+	/**
+	 * @brief Loads pixmaps asynchronously: read (io workers) -> decode -> convert -> resize (cpu workers).
+	 * @tparam T The pixel format of the loaded pixmaps.
+	 * @tparam Decoded The pixel format produced by the decoder.
+	 * @tparam Allocator The allocator of the loaded pixmaps.
+	 *
+	 * @note
+	 * The pixmaps are allocated on the worker threads, which are not registered with the garbage collector,
+	 * so the default allocator is std::allocator rather than memory::AnyAllocator.
+	 */
+	template<typename T, typename Decoded = T, typename Allocator = std::allocator<T>>
+	class LoadPipeline
+	{
+	public:
+		using size_type				= std::size_t;
+
+		using handle_type			= LoadHandle<T, Allocator>;
+		using state_type			= typename handle_type::state_type;
+		using pixmap_type			= typename handle_type::pixmap_type;
+		using result_type			= typename handle_type::result_type;
+
+		using decoded_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<Decoded>;
+		using decoded_pixmap_type	= Pixmap<Decoded, decoded_allocator_type>;
+
+		using decoder_type			= std::function<decoded_pixmap_type(std::span<const std::byte>)>;
+		using converter_type		= std::function<T(const Decoded&)>;
+
+		constexpr static size_type default_io_threads	 = 2;
+		constexpr static size_type default_max_in_flight = 64;
+
+		[[nodiscard]] static auto default_cpu_threads() noexcept -> size_type
+		{
+			return std::max(std::thread::hardware_concurrency(), 2u) - 1;
+		}
+
+	private:
+		struct DetachedTask
+		{
+			struct promise_type
+			{
+				[[nodiscard]] constexpr auto get_return_object() const noexcept -> DetachedTask { return {}; }
+
+				[[nodiscard]] constexpr auto initial_suspend() const noexcept -> std::suspend_never { return {}; }
+
+				[[nodiscard]] constexpr auto final_suspend() const noexcept -> std::suspend_never { return {}; }
+
+				constexpr auto return_void() const noexcept -> void {}
+
+				[[noreturn]] auto unhandled_exception() const noexcept -> void { std::terminate(); }
+			};
+		};
+
+		struct SlotWaiter
+		{
+			LoadPriority			priority;
+			std::uint64_t			sequence;
+			std::coroutine_handle<> handle;
+
+			[[nodiscard]] constexpr auto operator<(const SlotWaiter& other) const noexcept -> bool
+			{
+				// Same order as the jobs of WorkerPool: the highest priority first, then first come first served.
+				if (priority != other.priority)
+				{
+					return priority < other.priority;
+				}
+				return sequence > other.sequence;
+			}
+		};
+
+		class SlotAwaiter
+		{
+			LoadPipeline&		  pipeline_;
+			std::filesystem::path path_;
+			LoadRequest			  request_;
+
+		public:
+			SlotAwaiter(LoadPipeline& pipeline, std::filesystem::path path, const LoadRequest request) noexcept
+				: pipeline_{pipeline},
+				  path_{std::move(path)},
+				  request_{request} {}
+
+			[[nodiscard]] constexpr auto await_ready() const noexcept -> bool
+			{
+				return false;
+			}
+
+			[[nodiscard]] auto await_suspend(const std::coroutine_handle<> handle) noexcept(false) -> bool
+			{
+				std::scoped_lock lock{pipeline_.slots_mutex_};
+				if (pipeline_.free_slots_ != 0)
+				{
+					--pipeline_.free_slots_;
+					return false;
+				}
+
+				// Resumed by release_slot, which hands its slot over.
+				pipeline_.slot_waiters_.push({.priority = request_.priority, .sequence = pipeline_.slot_sequence_++, .handle = handle});
+				return true;
+			}
+
+			[[nodiscard]] auto await_resume() noexcept(false) -> handle_type
+			{
+				return pipeline_.start(std::move(path_), request_);
+			}
+		};
+
+		decoder_type					decoder_;
+		converter_type					converter_;
+
+		size_type						max_in_flight_;
+		std::mutex						slots_mutex_;
+		std::condition_variable			slots_condition_;
+		size_type						free_slots_;
+		std::priority_queue<SlotWaiter>	slot_waiters_;
+		std::uint64_t					slot_sequence_;
+		std::stop_source				stop_source_;
+
+		// The io workers hand their jobs over to the cpu workers, so the cpu workers must outlive them.
+		WorkerPool						cpu_pool_;
+		WorkerPool						io_pool_;
+
+		[[nodiscard]] static auto read_file(const std::filesystem::path& path) noexcept(false) -> std::vector<std::byte>
+		{
+			std::ifstream file{path, std::ios::binary};
+			if (not file.is_open())
+			{
+				throw utility::make_exception(std::format("Cannot open file `{}`!", path.string()));
+			}
+
+			std::vector<std::byte> bytes(static_cast<std::size_t>(std::filesystem::file_size(path)));
+			if (not file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size())))
+			{
+				throw utility::make_exception(std::format("Cannot read file `{}`!", path.string()));
+			}
+			return bytes;
+		}
+
+		auto check_cancelled(const state_type& state, const std::filesystem::path& path) const noexcept(false) -> void
+		{
+			if (state.stop_requested() or stop_source_.stop_requested())
+			{
+				throw utility::make_exception<LoadCancelled>(std::format("Loading `{}` was cancelled!", path.string()));
+			}
+		}
+
+		[[nodiscard]] auto finish(decoded_pixmap_type decoded, const LoadRequest request) const noexcept(false) -> pixmap_type
+		{
+			const auto width  = request.width == 0 ? decoded.width() : request.width;
+			const auto height = request.height == 0 ? decoded.height() : request.height;
+
+			if constexpr (std::is_same_v<decoded_pixmap_type, pixmap_type>)
+			{
+				if (not converter_)
+				{
+					if (width == decoded.width() and height == decoded.height())
+					{
+						return decoded;
+					}
+
+					pixmap_type resized{width, height};
+					resize_nearest(PixmapView<const T>{decoded}, PixmapView<T>{resized});
+					return resized;
+				}
+			}
+
+			pixmap_type converted{decoded.width(), decoded.height()};
+			convert(PixmapView<const Decoded>{decoded}, PixmapView<T>{converted}, std::cref(converter_));
+			if (width == converted.width() and height == converted.height())
+			{
+				return converted;
+			}
+
+			pixmap_type resized{width, height};
+			resize_nearest(PixmapView<const T>{converted}, PixmapView<T>{resized});
+			return resized;
+		}
+
+		auto run(std::filesystem::path path, const LoadRequest request, std::shared_ptr<state_type> state) -> DetachedTask
+		{
+			std::optional<pixmap_type> pixmap;
+			std::exception_ptr		   error;
+
+			try
+			{
+				co_await io_pool_.schedule(request.priority);
+				check_cancelled(*state, path);
+				auto bytes = read_file(path);
+
+				co_await cpu_pool_.schedule(request.priority);
+				check_cancelled(*state, path);
+				auto decoded = decoder_(std::span<const std::byte>{bytes});
+				std::vector<std::byte>{}.swap(bytes);
+
+				check_cancelled(*state, path);
+				pixmap.emplace(finish(std::move(decoded), request));
+			}
+			catch (...)
+			{
+				error = std::current_exception();
+			}
+
+			// The pipeline must not be accessed after the slot is released (see ~LoadPipeline).
+			release_slot();
+
+			if (error)
+			{
+				state->complete(result_type{std::unexpect, std::move(error)});
+			}
+			else
+			{
+				state->complete(result_type{std::move(*pixmap)});
+			}
+		}
+
+		auto release_slot() noexcept(false) -> void
+		{
+			std::unique_lock lock{slots_mutex_};
+			if (slot_waiters_.empty())
+			{
+				++free_slots_;
+				// Notified under the lock, ~LoadPipeline cannot return before it is released.
+				slots_condition_.notify_all();
+				return;
+			}
+
+			const auto waiter = slot_waiters_.top();
+			slot_waiters_.pop();
+			lock.unlock();
+
+			// The slot now belongs to the waiter, so the pipeline is still alive.
+			cpu_pool_.post(waiter.priority, waiter.handle);
+		}
+
+		/**
+		 * @brief Starts run with the slot taken by the caller, the slot is released if run cannot be started.
+		 */
+		[[nodiscard]] auto start(std::filesystem::path path, const LoadRequest request) noexcept(false) -> handle_type
+		{
+			try
+			{
+				auto state = std::make_shared<state_type>(request.priority);
+				// Once its frame is allocated, run owns the slot and releases it itself.
+				run(std::move(path), request, state);
+				return handle_type{std::move(state)};
+			}
+			catch (...)
+			{
+				release_slot();
+				throw;
+			}
+		}
+
+	public:
+		LoadPipeline(const LoadPipeline&)					 = delete;
+		LoadPipeline(LoadPipeline&&)						 = delete;
+		auto operator=(const LoadPipeline&) -> LoadPipeline& = delete;
+		auto operator=(LoadPipeline&&) -> LoadPipeline&		 = delete;
+
+		/**
+		 * @param decoder Decodes the content of a file, invoked on the cpu workers.
+		 * @param converter Converts the decoded pixels, may be empty if Decoded is T.
+		 * @param io_threads The number of workers reading files.
+		 * @param cpu_threads The number of workers decoding / converting / resizing.
+		 * @param max_in_flight The maximum number of pending loads, load blocks, async_load suspends and try_load fails beyond it.
+		 */
+		explicit LoadPipeline(
+				decoder_type	decoder,
+				converter_type	converter	  = {},
+				const size_type io_threads	  = default_io_threads,
+				const size_type cpu_threads	  = default_cpu_threads(),
+				const size_type max_in_flight = default_max_in_flight) noexcept(false)
+			: decoder_{std::move(decoder)},
+			  converter_{std::move(converter)},
+			  max_in_flight_{max_in_flight},
+			  free_slots_{max_in_flight},
+			  slot_sequence_{0},
+			  cpu_pool_{cpu_threads},
+			  io_pool_{io_threads}
+		{
+			GAL_ASSUME(decoder_ != nullptr, "A decoder is required!");
+			GAL_ASSUME((std::is_same_v<T, Decoded> or converter_ != nullptr), "A converter is required if the decoded pixel format is different!");
+			GAL_ASSUME(max_in_flight_ != 0, "At least one load must be allowed!");
+		}
+
+		/**
+		 * @brief Cancels all pending loads and waits for them to complete.
+		 */
+		~LoadPipeline() noexcept
+		{
+			stop_source_.request_stop();
+
+			std::unique_lock lock{slots_mutex_};
+			slots_condition_.wait(lock, [this] { return free_slots_ == max_in_flight_; });
+		}
+
+		/**
+		 * @brief Starts loading the file, blocks while max_in_flight loads are pending.
+		 * @note
+		 * Must not be called on the workers of this pipeline (e.g. in a callback passed to LoadHandle::then),
+		 * the blocked worker may be the one that has to complete a pending load, use async_load or try_load instead.
+		 */
+		[[nodiscard]] auto load(std::filesystem::path path, const LoadRequest request = {}) noexcept(false) -> handle_type
+		{
+			GAL_ASSUME(not cpu_pool_.is_worker_thread() and not io_pool_.is_worker_thread(), "Blocking on a worker of the pipeline may deadlock!");
+
+			{
+				std::unique_lock lock{slots_mutex_};
+				slots_condition_.wait(lock, [this] { return free_slots_ != 0; });
+				--free_slots_;
+			}
+			return start(std::move(path), request);
+		}
+
+		/**
+		 * @brief Starts loading the file, or returns std::nullopt if max_in_flight loads are pending.
+		 */
+		[[nodiscard]] auto try_load(std::filesystem::path path, const LoadRequest request = {}) noexcept(false) -> std::optional<handle_type>
+		{
+			{
+				std::scoped_lock lock{slots_mutex_};
+				if (free_slots_ == 0)
+				{
+					return std::nullopt;
+				}
+				--free_slots_;
+			}
+			return start(std::move(path), request);
+		}
+
+		/**
+		 * @brief co_await pipeline.async_load(path) starts loading the file and returns its handle,
+		 * the awaiting coroutine is suspended while max_in_flight loads are pending and then resumed on a cpu worker.
+		 * @note Unlike load, it can be used on any thread.
+		 */
+		[[nodiscard]] auto async_load(std::filesystem::path path, const LoadRequest request = {}) noexcept -> SlotAwaiter
+		{
+			return {*this, std::move(path), request};
+		}
+	};
+}// namespace gal::gui::image
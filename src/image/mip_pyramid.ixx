@@ -0,0 +1,175 @@
+module;
+
+#include <macro.hpp>
+
+export module gal.image:mip_pyramid;
+
+import std;
+import gal.utility;
+import :pixmap;
+import :reduction;
+
+namespace gal::gui::image
+{
+	/**
+	 * @brief dest(x, y) = box average of source(2x .. 2x + 1, 2y .. 2y + 1) for the dest texels in [begin_x, end_x) x [begin_y, end_y).
+	 * @note The last column / row of an odd sized source is repeated, so that every source texel contributes to the next level.
+	 */
+	template<typename T>
+	constexpr auto mip_downsample(
+			const PixmapView<const T> source,
+			PixmapView<T>			  dest,
+			const std::size_t		  begin_x,
+			const std::size_t		  end_x,
+			const std::size_t		  begin_y,
+			const std::size_t		  end_y) noexcept -> void
+	{
+		using sum_type	  = reduction_sum_type<T>;
+
+		const auto last_x = source.width() - 1;
+		const auto last_y = source.height() - 1;
+
+		for (auto y = begin_y; y < end_y; ++y)
+		{
+			const auto* top	   = source[2 * y].data();
+			const auto* bottom = source[std::ranges::min(2 * y + 1, last_y)].data();
+			auto*		row	   = dest[y].data();
+
+			for (auto x = begin_x; x < end_x; ++x)
+			{
+				const auto left	 = 2 * x;
+				const auto right = std::ranges::min(2 * x + 1, last_x);
+
+				const auto sum	 = static_cast<sum_type>(top[left]) + static_cast<sum_type>(top[right]) + static_cast<sum_type>(bottom[left]) + static_cast<sum_type>(bottom[right]);
+
+				if constexpr (std::is_floating_point_v<T>)
+				{
+					row[x] = static_cast<T>(sum / 4);
+				}
+				else
+				{
+					// Round half up: >> is a floor division for negative sums too, unlike / which truncates toward zero.
+					row[x] = static_cast<T>((sum + 2) >> 2);
+				}
+			}
+		}
+	}
+
+	export
+	{
+		/**
+		 * @brief All mip levels of a pixmap, level 0 is a copy of the pixmap and every next level halves (rounding up) both sides, down to 1 x 1.
+		 * @tparam T The pixel format, a single channel.
+		 *
+		 * @note
+		 * After a sub rectangle of the pixmap changed, update only recomputes the texels covering that rectangle on each level,
+		 * i.e. roughly 4/3 of the rectangle in total instead of 4/3 of the whole pixmap.
+		 */
+		template<typename T>
+			requires std::is_arithmetic_v<T>
+		class MipPyramid
+		{
+		public:
+			using value_type = T;
+			using size_type	 = std::size_t;
+
+			using level_type = Pixmap<value_type>;
+
+		private:
+			std::vector<level_type> levels_;
+
+		public:
+			constexpr MipPyramid() noexcept = default;
+
+			constexpr explicit MipPyramid(const PixmapView<const value_type> source) noexcept(false)
+			{
+				build(source);
+			}
+
+			/**
+			 * @brief The number of levels, including level 0.
+			 */
+			[[nodiscard]] constexpr auto levels() const noexcept -> size_type
+			{
+				return levels_.size();
+			}
+
+			[[nodiscard]] constexpr auto empty() const noexcept -> bool
+			{
+				return levels_.empty();
+			}
+
+			[[nodiscard]] constexpr auto level(const size_type index) const noexcept -> PixmapView<const value_type>
+			{
+				GAL_ASSUME(index < levels_.size());
+
+				return levels_[index];
+			}
+
+			/**
+			 * @brief Rebuilds all levels, the storage is reused if the size did not change.
+			 */
+			constexpr auto build(const PixmapView<const value_type> source) noexcept(false) -> void
+			{
+				if (source.empty())
+				{
+					levels_.clear();
+					return;
+				}
+
+				if (levels_.empty() or levels_.front().width() != source.width() or levels_.front().height() != source.height())
+				{
+					levels_.clear();
+
+					auto width	= source.width();
+					auto height = source.height();
+					levels_.emplace_back(width, height);
+					while (width > 1 or height > 1)
+					{
+						width  = (width + 1) / 2;
+						height = (height + 1) / 2;
+						levels_.emplace_back(width, height);
+					}
+				}
+
+				update(source, 0, 0, source.width(), source.height());
+			}
+
+			/**
+			 * @brief Updates all levels after the pixels in the rectangle of source have changed.
+			 */
+			constexpr auto update(const PixmapView<const value_type> source, size_type x, size_type y, size_type width, size_type height) noexcept -> void
+			{
+				GAL_ASSUME(not levels_.empty() and source.width() == levels_.front().width() and source.height() == levels_.front().height(), "Size mismatch, build the pyramid again!");
+				GAL_ASSUME(x + width <= source.width() and y + height <= source.height());
+
+				if (width == 0 or height == 0)
+				{
+					return;
+				}
+
+				{
+					auto dest = PixmapView<value_type>{levels_.front()}.sub_view(x, y, width, height);
+					const auto from = source.sub_view(x, y, width, height);
+					for (size_type row = 0; row < height; ++row)
+					{
+						std::ranges::copy(from[row], dest[row].begin());
+					}
+				}
+
+				for (size_type index = 1; index < levels_.size(); ++index)
+				{
+					// [x, x + width) on the previous level => [x / 2, (x + width - 1) / 2] on this level
+					const auto end_x = (x + width - 1) / 2 + 1;
+					const auto end_y = (y + height - 1) / 2 + 1;
+					x /= 2;
+					y /= 2;
+					width  = end_x - x;
+					height = end_y - y;
+
+					mip_downsample<value_type>(levels_[index - 1], levels_[index], x, end_x, y, end_y);
+				}
+			}
+		};
+	}
+}// namespace gal::gui::image
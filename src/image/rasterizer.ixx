@@ -0,0 +1,532 @@
+module;
+
+#include <macro.hpp>
+
+export module gal.image:rasterizer;
+
+import std;
+import gal.utility;
+import :pixmap;
+
+namespace gal::gui::image
+{
+	// Maximum distance (in pixels) between a curve and the lines it is flattened into.
+	constexpr float		  rasterizer_flatten_tolerance = 0.1f;
+	// Upper bound of the lines a single curve is flattened into, whatever its size.
+	constexpr std::size_t rasterizer_max_curve_lines   = 1024;
+	// Rows of at least rasterizer_lanes * rasterizer_min_chunk pixels are scanned as rasterizer_lanes interleaved chunks.
+	// (Below that the bookkeeping costs more than the overlapped additions save, see benchmark_rasterizer.)
+	constexpr std::size_t rasterizer_lanes			   = 8;
+	constexpr std::size_t rasterizer_min_chunk		   = 32;
+	// Every row of the accumulation buffer has two extra cells, an edge on the right border (x == width) writes up to x + 1.
+	constexpr std::size_t rasterizer_row_padding	   = 2;
+
+	export
+	{
+		enum class FillRule : std::uint8_t
+		{
+			nonzero,
+			even_odd,
+		};
+
+		struct Point
+		{
+			float x;
+			float y;
+
+			[[nodiscard]] constexpr auto operator==(const Point&) const noexcept -> bool = default;
+		};
+
+		struct Line
+		{
+			Point from;
+			Point to;
+		};
+
+		/**
+		 * @brief A path made of lines, quadratic and cubic Béziers, in pixel coordinates.
+		 *
+		 * @note
+		 * The curves are flattened into lines as they are added, so that the rasterizer only ever sees lines.
+		 * Every subpath is implicitly closed when filled.
+		 * clear() keeps the storage, a path can be reused to build the next shape without allocating.
+		 */
+		class Path
+		{
+		public:
+			using size_type = std::size_t;
+
+		private:
+			std::vector<Line> lines_;
+
+			Point			  start_;
+			Point			  current_;
+
+			Point			  min_;
+			Point			  max_;
+
+			constexpr auto	  add_line(const Point from, const Point to) noexcept(false) -> void
+			{
+				if (lines_.empty())
+				{
+					min_ = {std::ranges::min(from.x, to.x), std::ranges::min(from.y, to.y)};
+					max_ = {std::ranges::max(from.x, to.x), std::ranges::max(from.y, to.y)};
+				}
+				else
+				{
+					min_ = {std::ranges::min({min_.x, from.x, to.x}), std::ranges::min({min_.y, from.y, to.y})};
+					max_ = {std::ranges::max({max_.x, from.x, to.x}), std::ranges::max({max_.y, from.y, to.y})};
+				}
+
+				lines_.push_back({from, to});
+			}
+
+			/**
+			 * @brief The number of lines whose distance to a curve is at most rasterizer_flatten_tolerance.
+			 * @param second_derivative An upper bound of |B''(t)| over [0, 1].
+			 */
+			[[nodiscard]] static auto flatten_count(const float second_derivative) noexcept -> size_type
+			{
+				// The distance between a curve and the chord of a parameter interval h is at most max|B''| * h^2 / 8.
+				const auto count = std::ceil(std::sqrt(second_derivative / (8 * rasterizer_flatten_tolerance)));
+				return std::ranges::clamp(static_cast<size_type>(count), size_type{1}, rasterizer_max_curve_lines);
+			}
+
+		public:
+			constexpr Path() noexcept
+				: start_{0, 0},
+				  current_{0, 0},
+				  min_{0, 0},
+				  max_{0, 0} {}
+
+			[[nodiscard]] constexpr auto empty() const noexcept -> bool
+			{
+				return lines_.empty();
+			}
+
+			[[nodiscard]] constexpr auto lines() const noexcept -> std::span<const Line>
+			{
+				return lines_;
+			}
+
+			/**
+			 * @brief The line closing the last subpath, a degenerate line if it is already closed.
+			 */
+			[[nodiscard]] constexpr auto closing_line() const noexcept -> Line
+			{
+				return {current_, start_};
+			}
+
+			/**
+			 * @brief The bounding box of all lines, {min, max}.
+			 */
+			[[nodiscard]] constexpr auto bounds() const noexcept -> std::pair<Point, Point>
+			{
+				return {min_, max_};
+			}
+
+			constexpr auto clear() noexcept -> void
+			{
+				lines_.clear();
+				start_	 = {0, 0};
+				current_ = {0, 0};
+				min_	 = {0, 0};
+				max_	 = {0, 0};
+			}
+
+			/**
+			 * @brief Starts a new subpath, the previous one is closed.
+			 */
+			constexpr auto move_to(const Point point) noexcept(false) -> Path&
+			{
+				close();
+
+				start_	 = point;
+				current_ = point;
+				return *this;
+			}
+
+			constexpr auto line_to(const Point point) noexcept(false) -> Path&
+			{
+				add_line(current_, point);
+
+				current_ = point;
+				return *this;
+			}
+
+			auto quad_to(const Point control, const Point point) noexcept(false) -> Path&
+			{
+				const auto from = current_;
+
+				// B''(t) = 2 * (from - 2 * control + point)
+				const auto count = flatten_count(2 * std::hypot(from.x - 2 * control.x + point.x, from.y - 2 * control.y + point.y));
+
+				auto	   last	 = from;
+				for (size_type i = 1; i < count; ++i)
+				{
+					const auto t	= static_cast<float>(i) / static_cast<float>(count);
+					const auto s	= 1 - t;
+
+					const auto next = Point{
+							s * s * from.x + 2 * s * t * control.x + t * t * point.x,
+							s * s * from.y + 2 * s * t * control.y + t * t * point.y};
+					add_line(last, next);
+					last = next;
+				}
+				add_line(last, point);
+
+				current_ = point;
+				return *this;
+			}
+
+			auto cubic_to(const Point control1, const Point control2, const Point point) noexcept(false) -> Path&
+			{
+				const auto from = current_;
+
+				// B''(t) = 6 * ((1 - t) * (from - 2 * control1 + control2) + t * (control1 - 2 * control2 + point))
+				const auto count = flatten_count(
+						6 * std::ranges::max(
+								std::hypot(from.x - 2 * control1.x + control2.x, from.y - 2 * control1.y + control2.y),
+								std::hypot(control1.x - 2 * control2.x + point.x, control1.y - 2 * control2.y + point.y)));
+
+				auto last = from;
+				for (size_type i = 1; i < count; ++i)
+				{
+					const auto t	= static_cast<float>(i) / static_cast<float>(count);
+					const auto s	= 1 - t;
+
+					const auto a	= s * s * s;
+					const auto b	= 3 * s * s * t;
+					const auto c	= 3 * s * t * t;
+					const auto d	= t * t * t;
+
+					const auto next = Point{
+							a * from.x + b * control1.x + c * control2.x + d * point.x,
+							a * from.y + b * control1.y + c * control2.y + d * point.y};
+					add_line(last, next);
+					last = next;
+				}
+				add_line(last, point);
+
+				current_ = point;
+				return *this;
+			}
+
+			/**
+			 * @brief Closes the current subpath with a line to its start.
+			 */
+			constexpr auto close() noexcept(false) -> Path&
+			{
+				if (current_ != start_)
+				{
+					add_line(current_, start_);
+					current_ = start_;
+				}
+				return *this;
+			}
+		};
+	}
+
+	/**
+	 * @brief Coverage of an accumulated signed area.
+	 */
+	template<FillRule Rule>
+	[[nodiscard]] constexpr auto rasterizer_coverage(const float area) noexcept -> float
+	{
+		const auto a = std::abs(area);
+		if constexpr (Rule == FillRule::nonzero)
+		{
+			return std::ranges::min(a, 1.f);
+		}
+		else
+		{
+			// triangle wave: 0 => 0, 1 => 1, 2 => 0, 3 => 1 ...
+			const auto folded = a - 2 * std::floor(a / 2);
+			return std::ranges::min(folded, 2 - folded);
+		}
+	}
+
+	/**
+	 * @brief dest = dest + coverage * (1 - dest), i.e. the shape is composited over the existing coverage.
+	 * @note Computed with floats and a signed conversion, both of which have vector instructions (an unsigned one or a division by 255 does not).
+	 */
+	[[nodiscard]] constexpr auto rasterizer_composite(const std::uint8_t dest, const float coverage) noexcept -> std::uint8_t
+	{
+		const auto d = static_cast<float>(dest);
+		return static_cast<std::uint8_t>(static_cast<std::int32_t>(d + coverage * (255 - d) + .5f));
+	}
+
+	/**
+	 * @brief In place prefix sum of accumulation[0, width), split into Chunks consecutive chunks (the last one also takes the remainder), each one summed from 0.
+	 * @return The sum of each chunk.
+	 *
+	 * @note
+	 * A prefix sum is one long dependency chain (one addition latency per pixel),
+	 * scanning the chunks in lockstep runs Chunks independent chains side by side instead.
+	 */
+	template<std::size_t Chunks>
+	auto rasterizer_scan(float* accumulation, const std::size_t width) noexcept -> std::array<float, Chunks>
+	{
+		const auto				  chunk = width / Chunks;
+
+		std::array<float, Chunks> sums{};
+		for (std::size_t x = 0; x < chunk; ++x)
+		{
+			for (std::size_t lane = 0; lane < Chunks; ++lane)
+			{
+				sums[lane] += accumulation[lane * chunk + x];
+				accumulation[lane * chunk + x] = sums[lane];
+			}
+		}
+
+		for (auto x = Chunks * chunk; x < width; ++x)
+		{
+			sums[Chunks - 1] += accumulation[x];
+			accumulation[x] = sums[Chunks - 1];
+		}
+
+		return sums;
+	}
+
+	/**
+	 * @brief Turns one row of the accumulation buffer into coverage, and clears it for the next call.
+	 *
+	 * @note
+	 * Two passes: the prefix sum of the row (see rasterizer_scan),
+	 * then the coverage of every pixel, which has no dependency between pixels and is vectorized.
+	 */
+	template<FillRule Rule>
+	auto rasterizer_accumulate_row(float* accumulation, std::uint8_t* dest, const std::size_t width) noexcept -> void
+	{
+		const auto resolve = [&]<std::size_t Chunks>(const std::array<float, Chunks>& sums) noexcept -> void
+		{
+			const auto chunk  = width / Chunks;
+
+			float	   offset = 0;
+			for (std::size_t lane = 0; lane < Chunks; ++lane)
+			{
+				const auto begin = lane * chunk;
+				const auto end	 = lane + 1 == Chunks ? width : begin + chunk;
+
+				for (auto x = begin; x < end; ++x)
+				{
+					dest[x]			= rasterizer_composite(dest[x], rasterizer_coverage<Rule>(accumulation[x] + offset));
+					accumulation[x] = 0;
+				}
+
+				offset += sums[lane];
+			}
+		};
+
+		if (width >= rasterizer_lanes * rasterizer_min_chunk)
+		{
+			resolve(rasterizer_scan<rasterizer_lanes>(accumulation, width));
+		}
+		else
+		{
+			resolve(rasterizer_scan<1>(accumulation, width));
+		}
+
+		for (std::size_t padding = 0; padding < rasterizer_row_padding; ++padding)
+		{
+			accumulation[width + padding] = 0;
+		}
+	}
+
+	export
+	{
+		/**
+		 * @brief Scanline rasterizer writing exact-area anti-aliased coverage.
+		 *
+		 * @note
+		 * Every line adds its signed area to the cells it crosses, and the coverage of a pixel is the running sum of its row up to that pixel.
+		 * The accumulation buffer only spans the bounding box of the path (clipped to dest),
+		 * and is kept between calls (and left cleared by each call), so that filling many small paths neither allocates nor clears memory.
+		 * Like every area accumulation rasterizer, the coverage is exact except in the pixels where two edges cross each other.
+		 */
+		class Rasterizer
+		{
+		public:
+			using size_type = std::size_t;
+
+		private:
+			std::vector<float> accumulation_;
+
+			/**
+			 * @brief Accumulates a line of the region, 0 <= x <= width, y is clipped to [0, height).
+			 */
+			auto accumulate_line(const Point from, const Point to, const size_type width, const size_type stride, const size_type height) noexcept -> void
+			{
+				if (from.y == to.y)
+				{
+					return;
+				}
+
+				const auto [direction, top, bottom] = from.y < to.y ? std::tuple{1.f, from, to} : std::tuple{-1.f, to, from};
+
+				const auto dxdy						= (bottom.x - top.x) / (bottom.y - top.y);
+
+				const auto right					= static_cast<float>(width);
+				const auto begin_y					= static_cast<size_type>(std::ranges::clamp(top.y, 0.f, static_cast<float>(height)));
+				const auto end_y					= static_cast<size_type>(std::ranges::clamp(std::ceil(bottom.y), 0.f, static_cast<float>(height)));
+
+				// the rounding errors of the interpolation must not leave the region
+				auto	   x						= std::ranges::clamp(top.x + dxdy * (static_cast<float>(begin_y) > top.y ? static_cast<float>(begin_y) - top.y : 0.f), 0.f, right);
+				for (auto y = begin_y; y < end_y; ++y)
+				{
+					auto*	   row		= accumulation_.data() + y * stride;
+
+					const auto dy		= std::ranges::min(static_cast<float>(y + 1), bottom.y) - std::ranges::max(static_cast<float>(y), top.y);
+					const auto x_next	= std::ranges::clamp(x + dxdy * dy, 0.f, right);
+					const auto d		= dy * direction;
+
+					const auto [x0, x1] = std::ranges::minmax(x, x_next);
+
+					const auto x0_floor = std::floor(x0);
+					const auto x1_ceil	= std::ceil(x1);
+					const auto x0_i		= static_cast<size_type>(x0_floor);
+					const auto x1_i		= static_cast<size_type>(x1_ceil);
+
+					if (x1_i <= x0_i + 1)
+					{
+						// the line stays in one cell, split its area between this cell and the next one
+						const auto x_mid = .5f * (x + x_next) - x0_floor;
+						row[x0_i] += d - d * x_mid;
+						row[x0_i + 1] += d * x_mid;
+					}
+					else
+					{
+						const auto scale   = 1 / (x1 - x0);
+						const auto x0_frac = x0 - x0_floor;
+						const auto x1_frac = x1 - x1_ceil + 1;
+						// area of the triangle in the first cell / of the triangle in the last cell
+						const auto a0	   = .5f * scale * (1 - x0_frac) * (1 - x0_frac);
+						const auto am	   = .5f * scale * x1_frac * x1_frac;
+
+						row[x0_i] += d * a0;
+						if (x1_i == x0_i + 2)
+						{
+							row[x0_i + 1] += d * (1 - a0 - am);
+						}
+						else
+						{
+							const auto a1 = scale * (1.5f - x0_frac);
+							row[x0_i + 1] += d * (a1 - a0);
+							for (auto i = x0_i + 2; i < x1_i - 1; ++i)
+							{
+								row[i] += d * scale;
+							}
+							const auto a2 = a1 + static_cast<float>(x1_i - x0_i - 3) * scale;
+							row[x1_i - 1] += d * (1 - a2 - am);
+						}
+						row[x1_i] += d * am;
+					}
+
+					x = x_next;
+				}
+			}
+
+			/**
+			 * @brief Accumulates a line of the region, the parts left (right) of the region are projected onto its left (right) border.
+			 * @note A line left of a pixel still changes the winding of the pixel, a line right of it does not.
+			 */
+			auto accumulate_clipped_line(const Point from, const Point to, const size_type width, const size_type stride, const size_type height) noexcept -> void
+			{
+				const auto right = static_cast<float>(width);
+
+				// the common case, nothing to clip
+				if (from.x >= 0 and from.x <= right and to.x >= 0 and to.x <= right)
+				{
+					accumulate_line(from, to, width, stride, height);
+					return;
+				}
+
+				// split the line where it crosses x == 0 and x == width
+				std::array<float, 4> split{0};
+				size_type			 count = 1;
+				for (const auto border: {0.f, right})
+				{
+					if ((from.x - border) * (to.x - border) < 0)
+					{
+						split[count++] = (border - from.x) / (to.x - from.x);
+					}
+				}
+				std::ranges::sort(split.begin(), split.begin() + count);
+				split[count++] = 1;
+
+				const auto at  = [&](const float t) noexcept -> Point
+				{
+					return {
+							std::ranges::clamp(from.x + (to.x - from.x) * t, 0.f, right),
+							from.y + (to.y - from.y) * t};
+				};
+
+				for (size_type i = 0; i + 1 < count; ++i)
+				{
+					accumulate_line(at(split[i]), i + 2 == count ? Point{std::ranges::clamp(to.x, 0.f, right), to.y} : at(split[i + 1]), width, stride, height);
+				}
+			}
+
+		public:
+			/**
+			 * @brief Fills path into dest, the coordinates of the path are relative to the top left corner of dest.
+			 * @note The coverage is composited over the existing one (dest = dest + coverage * (1 - dest)), clear dest first for a fresh mask.
+			 */
+			auto fill(const Path& path, PixmapView<std::uint8_t> dest, const FillRule rule = FillRule::nonzero) noexcept(false) -> void
+			{
+				if (path.empty() or dest.empty())
+				{
+					return;
+				}
+
+				// the pixels the path can touch
+				const auto [min, max] = path.bounds();
+				const auto clamp	  = [](const float value, const size_type limit) noexcept -> size_type
+				{
+					return static_cast<size_type>(std::ranges::clamp(value, 0.f, static_cast<float>(limit)));
+				};
+
+				const auto begin_x = clamp(std::floor(min.x), dest.width());
+				const auto begin_y = clamp(std::floor(min.y), dest.height());
+				const auto end_x   = clamp(std::ceil(max.x), dest.width());
+				const auto end_y   = clamp(std::ceil(max.y), dest.height());
+
+				if (begin_x >= end_x or begin_y >= end_y)
+				{
+					return;
+				}
+
+				const auto width  = end_x - begin_x;
+				const auto height = end_y - begin_y;
+				const auto stride = width + rasterizer_row_padding;
+
+				// the cells are left cleared by the previous calls, only the new ones have to be value initialized
+				if (accumulation_.size() < stride * height)
+				{
+					accumulation_.resize(stride * height);
+				}
+
+				const auto offset_x = static_cast<float>(begin_x);
+				const auto offset_y = static_cast<float>(begin_y);
+				const auto add		= [&](const Line line) noexcept -> void
+				{
+					accumulate_clipped_line(
+							{line.from.x - offset_x, line.from.y - offset_y},
+							{line.to.x - offset_x, line.to.y - offset_y},
+							width,
+							stride,
+							height);
+				};
+
+				std::ranges::for_each(path.lines(), add);
+				add(path.closing_line());
+
+				const auto accumulate = rule == FillRule::nonzero ? &rasterizer_accumulate_row<FillRule::nonzero> : &rasterizer_accumulate_row<FillRule::even_odd>;
+				for (size_type y = 0; y < height; ++y)
+				{
+					accumulate(accumulation_.data() + y * stride, dest[begin_y + y].data() + begin_x, width);
+				}
+			}
+		};
+	}
+}// namespace gal::gui::image
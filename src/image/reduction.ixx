@@ -0,0 +1,497 @@
+module;
+
+#include <macro.hpp>
+
+export module gal.image:reduction;
+
+import std;
+import gal.utility;
+import gal.simd;
+import :pixmap;
+
+namespace gal::gui::image
+{
+	// One cache line per block, held in one simd (a single vector register, or two / four of them on narrower targets).
+	template<typename T>
+	constexpr std::size_t reduction_lanes = std::max<std::size_t>(64 / sizeof(T), 1);
+
+	template<typename T>
+	using reduction_sum_type = std::conditional_t<
+			std::is_floating_point_v<T>,
+			double,
+			std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>>;
+
+	// Narrow integers are summed in 32-bit lanes, which are flushed into reduction_sum_type before they can overflow.
+	template<typename T>
+	using reduction_lane_sum_type = std::conditional_t<
+			std::is_integral_v<T> and sizeof(T) <= 2,
+			std::conditional_t<std::is_signed_v<T>, std::int32_t, std::uint32_t>,
+			reduction_sum_type<T>>;
+
+	template<typename T>
+	constexpr std::size_t reduction_flush_interval = std::is_integral_v<T> and sizeof(T) <= 2 ? std::size_t{1} << 15 : std::numeric_limits<std::size_t>::max();
+
+	/**
+	 * @brief Splits [0, height) into bands and invokes function(band, begin_y, end_y) for each band, every band except the first one on its own thread.
+	 * @return The number of bands.
+	 */
+	template<typename Function>
+	auto for_each_band(const std::size_t height, const std::size_t threads, Function& function) noexcept(false) -> std::size_t
+	{
+		const auto bands = std::clamp<std::size_t>(threads, 1, std::max<std::size_t>(height, 1));
+
+		std::vector<std::jthread> workers;
+		workers.reserve(bands - 1);
+		for (std::size_t band = 1; band < bands; ++band)
+		{
+			workers.emplace_back([&function, band, bands, height] { function(band, band * height / bands, (band + 1) * height / bands); });
+		}
+		function(static_cast<std::size_t>(0), static_cast<std::size_t>(0), height / bands);
+
+		return bands;
+	}
+
+	template<typename T>
+	auto minmax_row(const T* row, const std::size_t width, T& min, T& max) noexcept -> void
+	{
+		std::size_t x = 0;
+		// bool and long double do not fit in a simd, they only take the scalar loop below.
+		if constexpr (simd::lane_type<T>)
+		{
+			constexpr auto lanes = reduction_lanes<T>;
+
+			if (width >= lanes)
+			{
+				auto mins = simd::load<lanes>(row);
+				auto maxs = mins;
+
+				for (x = lanes; x + lanes <= width; x += lanes)
+				{
+					const auto value = simd::load<lanes>(row + x);
+					mins			 = simd::min(mins, value);
+					maxs			 = simd::max(maxs, value);
+				}
+
+				min = std::ranges::min(min, simd::minimum(mins));
+				max = std::ranges::max(max, simd::maximum(maxs));
+			}
+		}
+
+		for (; x < width; ++x)
+		{
+			min = std::ranges::min(min, row[x]);
+			max = std::ranges::max(max, row[x]);
+		}
+	}
+
+	template<typename T>
+	auto sum_row(const T* row, const std::size_t width) noexcept -> reduction_sum_type<T>
+	{
+		using sum_type		= reduction_sum_type<T>;
+		using lane_sum_type = reduction_lane_sum_type<T>;
+
+		sum_type	result{0};
+		std::size_t x = 0;
+		if constexpr (simd::lane_type<T>)
+		{
+			// One cache line of accumulators, the pixels are widened to them as they are loaded.
+			constexpr auto lanes = reduction_lanes<lane_sum_type>;
+			using sum_simd_type	 = simd::simd<lane_sum_type, lanes>;
+
+			// The lanes are widened to sum_type before they are added together, 32-bit lanes close to the flush interval would overflow.
+			const auto	   flush = [](const sum_simd_type sums) noexcept -> sum_type
+			{
+				return simd::sum(simd::convert<sum_type>(sums));
+			};
+
+			sum_simd_type sums{lane_sum_type{0}};
+			std::size_t	  blocks = 0;
+			for (; x + lanes <= width; x += lanes)
+			{
+				sums += simd::convert<lane_sum_type>(simd::load<lanes>(row + x));
+
+				if (++blocks == reduction_flush_interval<T>)
+				{
+					result += flush(sums);
+					sums   = sum_simd_type{lane_sum_type{0}};
+					blocks = 0;
+				}
+			}
+			result += flush(sums);
+		}
+
+		for (; x < width; ++x)
+		{
+			result += static_cast<reduction_sum_type<T>>(row[x]);
+		}
+
+		return result;
+	}
+
+	template<typename T, typename Predicate>
+	constexpr auto any_of_row(const T* row, const std::size_t width, Predicate& predicate) noexcept(std::is_nothrow_invocable_v<Predicate&, const T&>) -> bool
+	{
+		constexpr auto lanes = reduction_lanes<T>;
+
+		std::size_t	   x	 = 0;
+		for (; x + lanes <= width; x += lanes)
+		{
+			// No early exit inside a block, the whole block is tested branch-free.
+			bool any = false;
+			for (std::size_t lane = 0; lane < lanes; ++lane)
+			{
+				any |= static_cast<bool>(predicate(row[x + lane]));
+			}
+
+			if (any)
+			{
+				return true;
+			}
+		}
+
+		for (; x < width; ++x)
+		{
+			if (predicate(row[x]))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	/**
+	 * @tparam Checked
+	 * If true, the projected bins are clamped into an extra overflow bin per sub-histogram, which must still be empty at the end,
+	 * so the range is checked once per call instead of branching on every pixel.
+	 */
+	template<bool Checked, typename T, typename Projection>
+	auto histogram_band(const PixmapView<const T> source, const std::size_t begin_y, const std::size_t end_y, Projection& projection, const std::span<std::size_t> bins) noexcept(false) -> void
+	{
+		// Consecutive pixels often fall into the same bin (e.g. flat areas), incrementing the same counter back to back stalls on the store-to-load forwarding,
+		// so 4 consecutive pixels go into 4 different sub-histograms which are merged at the end.
+		constexpr std::size_t	 sub_histograms = 4;
+
+		const auto				 bin_count		= bins.size();
+		const auto				 sub_size		= Checked ? bin_count + 1 : bin_count;
+		std::vector<std::size_t> sub(sub_histograms * sub_size, 0);
+
+		auto*					 sub_0			= sub.data();
+		auto*					 sub_1			= sub_0 + sub_size;
+		auto*					 sub_2			= sub_1 + sub_size;
+		auto*					 sub_3			= sub_2 + sub_size;
+
+		const auto				 bin			= [&projection, bin_count](const T& pixel) -> std::size_t
+		{
+			const auto index = static_cast<std::size_t>(projection(pixel));
+			if constexpr (Checked)
+			{
+				return std::ranges::min(index, bin_count);
+			}
+			else
+			{
+				return index;
+			}
+		};
+
+		for (auto y = begin_y; y < end_y; ++y)
+		{
+			const auto* row	  = source[y].data();
+			const auto	width = source.width();
+
+			std::size_t x	  = 0;
+			for (; x + sub_histograms <= width; x += sub_histograms)
+			{
+				++sub_0[bin(row[x + 0])];
+				++sub_1[bin(row[x + 1])];
+				++sub_2[bin(row[x + 2])];
+				++sub_3[bin(row[x + 3])];
+			}
+
+			for (; x < width; ++x)
+			{
+				++sub_0[bin(row[x])];
+			}
+		}
+
+		if constexpr (Checked)
+		{
+			GAL_ASSUME(sub_0[bin_count] + sub_1[bin_count] + sub_2[bin_count] + sub_3[bin_count] == 0, "The projected bin is out of range!");
+		}
+
+		for (std::size_t i = 0; i < bin_count; ++i)
+		{
+			bins[i] += sub_0[i] + sub_1[i] + sub_2[i] + sub_3[i];
+		}
+	}
+
+	export
+	{
+		template<typename T>
+		struct MinMax
+		{
+			T min;
+			T max;
+		};
+
+		/**
+		 * @brief A rectangle in pixel coordinates, suitable for PixmapView::sub_view.
+		 */
+		struct Bounds
+		{
+			std::size_t x;
+			std::size_t y;
+			std::size_t width;
+			std::size_t height;
+
+			[[nodiscard]] constexpr auto empty() const noexcept -> bool
+			{
+				return width == 0 or height == 0;
+			}
+
+			[[nodiscard]] constexpr auto operator==(const Bounds& other) const noexcept -> bool = default;
+		};
+
+		/**
+		 * @brief The minimum and maximum pixel.
+		 * @param threads The rows are split into this many bands, each band is reduced on its own thread.
+		 * @return {numeric_limits::max, numeric_limits::lowest} if source is empty.
+		 */
+		template<typename T>
+			requires std::is_arithmetic_v<std::remove_const_t<T>>
+		[[nodiscard]] auto minmax(const PixmapView<T> source, const std::size_t threads = 1) noexcept(false) -> MinMax<std::remove_const_t<T>>
+		{
+			using value_type  = std::remove_const_t<T>;
+			using result_type = MinMax<value_type>;
+
+			const PixmapView<const value_type> view{source};
+
+			std::vector<result_type>		   partials(
+					 std::max<std::size_t>(threads, 1),
+					 result_type{.min = std::numeric_limits<value_type>::max(), .max = std::numeric_limits<value_type>::lowest()});
+
+			auto band_function = [&view, &partials](const std::size_t band, const std::size_t begin_y, const std::size_t end_y) noexcept -> void
+			{
+				auto& [min, max] = partials[band];
+				for (auto y = begin_y; y < end_y; ++y)
+				{
+					minmax_row(view[y].data(), view.width(), min, max);
+				}
+			};
+			const auto bands  = for_each_band(view.height(), threads, band_function);
+
+			auto	   result = partials.front();
+			for (std::size_t band = 1; band < bands; ++band)
+			{
+				result.min = std::ranges::min(result.min, partials[band].min);
+				result.max = std::ranges::max(result.max, partials[band].max);
+			}
+			return result;
+		}
+
+		/**
+		 * @brief The sum of all pixels, accumulated in 64-bit integers (or double for floating point pixels).
+		 */
+		template<typename T>
+			requires std::is_arithmetic_v<std::remove_const_t<T>>
+		[[nodiscard]] auto sum(const PixmapView<T> source, const std::size_t threads = 1) noexcept(false) -> reduction_sum_type<std::remove_const_t<T>>
+		{
+			using value_type  = std::remove_const_t<T>;
+			using result_type = reduction_sum_type<value_type>;
+
+			const PixmapView<const value_type> view{source};
+
+			std::vector<result_type>		   partials(std::max<std::size_t>(threads, 1), result_type{0});
+
+			auto band_function = [&view, &partials](const std::size_t band, const std::size_t begin_y, const std::size_t end_y) noexcept -> void
+			{
+				for (auto y = begin_y; y < end_y; ++y)
+				{
+					partials[band] += sum_row(view[y].data(), view.width());
+				}
+			};
+			const auto bands = for_each_band(view.height(), threads, band_function);
+
+			return std::reduce(partials.begin(), partials.begin() + static_cast<std::ptrdiff_t>(bands), result_type{0});
+		}
+
+		/**
+		 * @brief The mean of all pixels, 0 if source is empty.
+		 */
+		template<typename T>
+			requires std::is_arithmetic_v<std::remove_const_t<T>>
+		[[nodiscard]] auto mean(const PixmapView<T> source, const std::size_t threads = 1) noexcept(false) -> double
+		{
+			if (source.width() == 0 or source.height() == 0)
+			{
+				return 0;
+			}
+
+			return static_cast<double>(sum(source, threads)) / static_cast<double>(source.size());
+		}
+
+		/**
+		 * @brief Counts the pixels per bin.
+		 * @tparam Bins The number of bins.
+		 * @param projection Maps a pixel to its bin, the result must be less than Bins (checked once the band is counted).
+		 */
+		template<std::size_t Bins, typename T, typename Projection>
+			requires std::is_convertible_v<std::invoke_result_t<Projection&, const std::remove_const_t<T>&>, std::size_t>
+		[[nodiscard]] auto histogram(const PixmapView<T> source, Projection projection, const std::size_t threads = 1) noexcept(false) -> std::array<std::size_t, Bins>
+		{
+			using value_type  = std::remove_const_t<T>;
+			using result_type = std::array<std::size_t, Bins>;
+
+			const PixmapView<const value_type> view{source};
+
+			std::vector<result_type>		   partials(std::max<std::size_t>(threads, 1), result_type{});
+
+			auto band_function = [&view, &partials, &projection](const std::size_t band, const std::size_t begin_y, const std::size_t end_y) -> void
+			{
+				// The 8-bit overload cannot go out of range, the other projections are checked.
+				constexpr auto checked = not(std::is_same_v<value_type, std::uint8_t> and std::is_same_v<Projection, std::identity> and Bins >= 256);
+				histogram_band<checked>(view, begin_y, end_y, projection, std::span<std::size_t>{partials[band]});
+			};
+			const auto bands  = for_each_band(view.height(), threads, band_function);
+
+			auto	   result = partials.front();
+			for (std::size_t band = 1; band < bands; ++band)
+			{
+				std::ranges::transform(result, partials[band], result.begin(), std::plus<>{});
+			}
+			return result;
+		}
+
+		/**
+		 * @brief The 256-bin histogram of an 8-bit pixmap, e.g. a luminance plane.
+		 */
+		template<typename T>
+			requires std::is_same_v<std::remove_const_t<T>, std::uint8_t>
+		[[nodiscard]] auto histogram(const PixmapView<T> source, const std::size_t threads = 1) noexcept(false) -> std::array<std::size_t, 256>
+		{
+			return histogram<256>(source, std::identity{}, threads);
+		}
+
+		/**
+		 * @brief The tight bounds of all pixels satisfying predicate (e.g. non-transparent pixels), empty if there is none.
+		 *
+		 * @note
+		 * The top and bottom rows are found with whole-row scans that stop at the first hit,
+		 * the left and right edges are then narrowed row by row, scanning only the columns outside the current bounds.
+		 */
+		template<typename T, typename Predicate>
+			requires std::predicate<Predicate&, const std::remove_const_t<T>&>
+		[[nodiscard]] auto opaque_bounds(const PixmapView<T> source, Predicate predicate, const std::size_t threads = 1) noexcept(false) -> Bounds
+		{
+			using value_type = std::remove_const_t<T>;
+
+			const PixmapView<const value_type> view{source};
+
+			const auto						   scan = [&predicate](const PixmapView<const value_type> band) -> Bounds
+			{
+				const auto width  = band.width();
+				const auto height = band.height();
+
+				std::size_t top	  = 0;
+				while (top < height and not any_of_row(band[top].data(), width, predicate))
+				{
+					++top;
+				}
+				if (top == height)
+				{
+					return {};
+				}
+
+				auto bottom = height;
+				while (not any_of_row(band[bottom - 1].data(), width, predicate))
+				{
+					--bottom;
+				}
+
+				auto left  = width;
+				// exclusive
+				auto right = static_cast<std::size_t>(0);
+				for (auto y = top; y < bottom and (left != 0 or right != width); ++y)
+				{
+					const auto* row = band[y].data();
+
+					for (std::size_t x = 0; x < left; ++x)
+					{
+						if (predicate(row[x]))
+						{
+							left = x;
+							break;
+						}
+					}
+
+					for (auto x = width; x > right; --x)
+					{
+						if (predicate(row[x - 1]))
+						{
+							right = x;
+							break;
+						}
+					}
+				}
+
+				return {.x = left, .y = top, .width = right - left, .height = bottom - top};
+			};
+
+			if (view.width() == 0 or view.height() == 0)
+			{
+				return {};
+			}
+
+			if (threads <= 1)
+			{
+				return scan(view);
+			}
+
+			std::vector<Bounds> partials(threads);
+
+			auto				band_function = [&view, &partials, &scan](const std::size_t band, const std::size_t begin_y, const std::size_t end_y) -> void
+			{
+				auto bounds = scan(view.sub_view(0, begin_y, view.width(), end_y - begin_y));
+				bounds.y += begin_y;
+				partials[band] = bounds;
+			};
+			const auto bands = for_each_band(view.height(), threads, band_function);
+
+			Bounds	   result{};
+			for (std::size_t band = 0; band < bands; ++band)
+			{
+				const auto& bounds = partials[band];
+				if (bounds.empty())
+				{
+					continue;
+				}
+
+				if (result.empty())
+				{
+					result = bounds;
+					continue;
+				}
+
+				const auto left	  = std::ranges::min(result.x, bounds.x);
+				const auto top	  = std::ranges::min(result.y, bounds.y);
+				const auto right  = std::ranges::max(result.x + result.width, bounds.x + bounds.width);
+				const auto bottom = std::ranges::max(result.y + result.height, bounds.y + bounds.height);
+				result			  = {.x = left, .y = top, .width = right - left, .height = bottom - top};
+			}
+			return result;
+		}
+
+		/**
+		 * @brief The tight bounds of all non-zero pixels.
+		 */
+		template<typename T>
+			requires std::is_arithmetic_v<std::remove_const_t<T>>
+		[[nodiscard]] auto opaque_bounds(const PixmapView<T> source, const std::size_t threads = 1) noexcept(false) -> Bounds
+		{
+			return opaque_bounds(
+					source,
+					[](const std::remove_const_t<T> pixel) noexcept -> bool { return pixel != std::remove_const_t<T>{}; },
+					threads);
+		}
+	}
+}// namespace gal::gui::image
@@ -0,0 +1,175 @@
+module;
+
+#include <macro.hpp>
+
+export module gal.image:summed_area_table;
+
+import std;
+import gal.utility;
+import gal.simd;
+import :pixmap;
+import :reduction;
+
+namespace gal::gui::image
+{
+	// One vector register of accumulators, i.e. 4 lanes of 64-bit sums.
+	template<typename Accumulator>
+	constexpr std::size_t summed_area_table_lanes = std::max<std::size_t>(32 / sizeof(Accumulator), 1);
+}// namespace gal::gui::image
+
+export namespace gal::gui::image
+{
+	/**
+	 * @brief The integral image of a pixmap, sum / mean of any rectangle in O(1).
+	 * @tparam T The pixel format, a single channel (build one table per channel otherwise).
+	 * @tparam Accumulator The type of the sums, 64-bit integers (or double for floating point pixels) by default so that even 8K pixmaps cannot overflow.
+	 *
+	 * @note
+	 * The table is (width + 1) x (height + 1), the first row and the first column are zero,
+	 * so that a query never has to check whether the rectangle touches the top or left edge.
+	 */
+	template<typename T, typename Accumulator = reduction_sum_type<T>>
+		requires std::is_arithmetic_v<T> and std::is_arithmetic_v<Accumulator>
+	class SummedAreaTable
+	{
+	public:
+		using value_type	   = T;
+		using accumulator_type = Accumulator;
+		using size_type		   = std::size_t;
+
+		using table_type	   = Pixmap<accumulator_type>;
+
+	private:
+		table_type table_;
+
+		/**
+		 * @brief Recomputes table[begin_y + 1 .., begin_x + 1 ..] from source, the rows above begin_y and the columns left of begin_x must be up to date.
+		 */
+		auto build_from(const PixmapView<const value_type> source, const size_type begin_x, const size_type begin_y) noexcept -> void
+		{
+			const auto width = source.width();
+
+			for (auto y = begin_y; y < source.height(); ++y)
+			{
+				const auto* source_row	 = source[y].data();
+				const auto* previous_row = table_[y].data();
+				auto*		current_row	 = table_[y + 1].data();
+
+				// The sum of source[y][0, begin_x).
+				auto		running		 = static_cast<accumulator_type>(current_row[begin_x] - previous_row[begin_x]);
+
+				auto		x			 = begin_x;
+				if constexpr (simd::lane_type<value_type> and simd::lane_type<accumulator_type>)
+				{
+					// Each block of the row is scanned in registers, only the running sum of the previous blocks is carried from one block to the next.
+					constexpr auto lanes = summed_area_table_lanes<accumulator_type>;
+
+					for (; x + lanes <= width; x += lanes)
+					{
+						const auto scanned = simd::inclusive_scan(simd::convert<accumulator_type>(simd::load<lanes>(source_row + x))) + running;
+						simd::store(scanned + simd::load<lanes>(previous_row + x + 1), current_row + x + 1);
+						running = scanned.get(lanes - 1);
+					}
+				}
+
+				for (; x < width; ++x)
+				{
+					running += static_cast<accumulator_type>(source_row[x]);
+					current_row[x + 1] = running + previous_row[x + 1];
+				}
+			}
+		}
+
+	public:
+		constexpr SummedAreaTable() noexcept = default;
+
+		explicit SummedAreaTable(const PixmapView<const value_type> source) noexcept(false)
+		{
+			build(source);
+		}
+
+		[[nodiscard]] constexpr auto width() const noexcept -> size_type
+		{
+			return table_.empty() ? 0 : table_.width() - 1;
+		}
+
+		[[nodiscard]] constexpr auto height() const noexcept -> size_type
+		{
+			return table_.empty() ? 0 : table_.height() - 1;
+		}
+
+		[[nodiscard]] constexpr auto empty() const noexcept -> bool
+		{
+			return width() == 0 or height() == 0;
+		}
+
+		/**
+		 * @brief Rebuilds the whole table, the storage is reused if the size did not change.
+		 */
+		auto build(const PixmapView<const value_type> source) noexcept(false) -> void
+		{
+			if (width() != source.width() or height() != source.height())
+			{
+				table_ = table_type{source.width() + 1, source.height() + 1};
+			}
+
+			build_from(source, 0, 0);
+		}
+
+		/**
+		 * @brief Updates the table after the pixels in the rectangle of source have changed.
+		 * @note Only the entries below and to the right of (x, y) depend on the rectangle, the others are left untouched.
+		 */
+		auto update(const PixmapView<const value_type> source, const size_type x, const size_type y, const size_type width, const size_type height) noexcept -> void
+		{
+			GAL_ASSUME(source.width() == this->width() and source.height() == this->height(), "Size mismatch, build the table again!");
+			GAL_ASSUME(x + width <= source.width() and y + height <= source.height());
+
+			if (width == 0 or height == 0)
+			{
+				return;
+			}
+
+			build_from(source, x, y);
+		}
+
+		/**
+		 * @brief The sum of the pixels in the rectangle.
+		 */
+		[[nodiscard]] constexpr auto sum(const size_type x, const size_type y, const size_type width, const size_type height) const noexcept -> accumulator_type
+		{
+			GAL_ASSUME(x + width <= this->width() and y + height <= this->height());
+
+			const auto* top	   = table_[y].data();
+			const auto* bottom = table_[y + height].data();
+
+			return bottom[x + width] - bottom[x] - top[x + width] + top[x];
+		}
+
+		/**
+		 * @brief The sum of all pixels.
+		 */
+		[[nodiscard]] constexpr auto sum() const noexcept -> accumulator_type
+		{
+			return empty() ? accumulator_type{0} : table_.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(width(), height());
+		}
+
+		/**
+		 * @brief The mean of the pixels in the rectangle, 0 if the rectangle is empty.
+		 */
+		[[nodiscard]] constexpr auto mean(const size_type x, const size_type y, const size_type width, const size_type height) const noexcept -> double
+		{
+			if (width == 0 or height == 0)
+			{
+				return 0;
+			}
+
+			return static_cast<double>(sum(x, y, width, height)) / static_cast<double>(width * height);
+		}
+
+		[[nodiscard]] constexpr auto table() const noexcept -> PixmapView<const accumulator_type>
+		{
+			return table_;
+		}
+	};
+}// namespace gal::gui::image
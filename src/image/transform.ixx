@@ -0,0 +1,328 @@
+module;
+
+#include <macro.hpp>
+
+export module gal.image:transform;
+
+import std;
+import gal.utility;
+import gal.simd;
+import :pixmap;
+
+namespace gal::gui::image
+{
+	// Side of the square tiles: one source tile and one dest tile stay in L1 while the tile is transposed,
+	// and a tile only touches a few dozen pages of each image, which keeps the TLB warm.
+	template<typename T>
+	constexpr std::size_t transform_tile_size = 32;
+
+	// Side of the micro tiles inside a tile, transposed in registers: 8 rows of 8 lanes for 1/2/4-byte pixels (8/16/32 bytes per row),
+	// 4 rows of 4 lanes for 8-byte pixels (32 bytes per row).
+	template<typename T>
+	constexpr std::size_t transform_micro_size = sizeof(T) == 8 ? 4 : 8;
+
+	/**
+	 * @brief Transposes the N x N block held by rows, N being a power of two.
+	 * @note log2(N) rounds of perfect shuffles (row 2i / 2i + 1 = interleave(row i, row i + N / 2)) transpose the block.
+	 */
+	template<typename T, std::size_t N>
+	auto transform_transpose(std::array<simd::simd<T, N>, N>& rows) noexcept -> void
+	{
+		for (std::size_t round = N; round > 1; round /= 2)
+		{
+			const auto previous = rows;
+			for (std::size_t i = 0; i < N / 2; ++i)
+			{
+				const auto [low, high] = simd::interleave(previous[i], previous[i + N / 2]);
+				rows[2 * i]			   = low;
+				rows[2 * i + 1]		   = high;
+			}
+		}
+	}
+
+	/**
+	 * @brief dest(ReverseX ? height - 1 - y : y, ReverseY ? width - 1 - x : x) = source(x, y), where width / height are the source's.
+	 *
+	 * @note
+	 * transpose => <false, false>
+	 * rotate 90 (clockwise) => <true, false>
+	 * rotate 270 (clockwise) => <false, true>
+	 */
+	template<bool ReverseX, bool ReverseY, typename T>
+	auto transpose_blocked(const PixmapView<const T> source, PixmapView<T> dest) noexcept -> void
+	{
+		constexpr auto tile	 = transform_tile_size<T>;
+		constexpr auto micro = transform_micro_size<T>;
+
+		const auto	   width  = source.width();
+		const auto	   height = source.height();
+
+		GAL_ASSUME(dest.width() == height, "Width mismatch!");
+		GAL_ASSUME(dest.height() == width, "Height mismatch!");
+
+		const auto*	   source_data	 = source.data();
+		auto*		   dest_data	 = dest.data();
+		const auto	   source_stride = source.stride();
+		const auto	   dest_stride	 = dest.stride();
+
+		const auto	   dest_x		 = [height](const std::size_t y) noexcept -> std::size_t
+		{
+			return ReverseX ? height - 1 - y : y;
+		};
+		const auto dest_y = [width](const std::size_t x) noexcept -> std::size_t
+		{
+			return ReverseY ? width - 1 - x : x;
+		};
+
+		const auto transpose_micro = [&](const std::size_t x, const std::size_t y) noexcept -> void
+		{
+			// Load the source rows first, then write the dest rows, so that neither the loads nor the stores are interleaved with a strided access.
+			if constexpr (simd::lane_type<T>)
+			{
+				std::array<simd::simd<T, micro>, micro> rows;
+				for (std::size_t i = 0; i < micro; ++i)
+				{
+					rows[i] = simd::load<micro>(source_data + (y + i) * source_stride + x);
+				}
+
+				transform_transpose<T, micro>(rows);
+
+				for (std::size_t j = 0; j < micro; ++j)
+				{
+					auto* dest_row = dest_data + dest_y(x + j) * dest_stride;
+					if constexpr (ReverseX)
+					{
+						// dest_x is decreasing, the row is stored reversed from the last dest column.
+						simd::store(simd::reverse(rows[j]), dest_row + dest_x(y + micro - 1));
+					}
+					else
+					{
+						simd::store(rows[j], dest_row + dest_x(y));
+					}
+				}
+			}
+			else
+			{
+				// Pixels that do not fit in a simd (e.g. structs) are gathered and scattered one by one.
+				std::array<T, micro * micro> block;
+				for (std::size_t i = 0; i < micro; ++i)
+				{
+					const auto* source_row = source_data + (y + i) * source_stride + x;
+					for (std::size_t j = 0; j < micro; ++j)
+					{
+						block[j * micro + i] = source_row[j];
+					}
+				}
+
+				for (std::size_t j = 0; j < micro; ++j)
+				{
+					auto* dest_row = dest_data + dest_y(x + j) * dest_stride;
+					for (std::size_t i = 0; i < micro; ++i)
+					{
+						dest_row[dest_x(y + i)] = block[j * micro + i];
+					}
+				}
+			}
+		};
+
+		const auto transpose_scalar = [&](const std::size_t begin_x, const std::size_t end_x, const std::size_t begin_y, const std::size_t end_y) noexcept -> void
+		{
+			for (auto x = begin_x; x < end_x; ++x)
+			{
+				auto* dest_row = dest_data + dest_y(x) * dest_stride;
+				for (auto y = begin_y; y < end_y; ++y)
+				{
+					dest_row[dest_x(y)] = source_data[y * source_stride + x];
+				}
+			}
+		};
+
+		for (std::size_t tile_y = 0; tile_y < height; tile_y += tile)
+		{
+			const auto tile_end_y  = std::ranges::min(tile_y + tile, height);
+			const auto micro_end_y = tile_y + (tile_end_y - tile_y) / micro * micro;
+
+			for (std::size_t tile_x = 0; tile_x < width; tile_x += tile)
+			{
+				const auto tile_end_x  = std::ranges::min(tile_x + tile, width);
+				const auto micro_end_x = tile_x + (tile_end_x - tile_x) / micro * micro;
+
+				for (auto y = tile_y; y < micro_end_y; y += micro)
+				{
+					for (auto x = tile_x; x < micro_end_x; x += micro)
+					{
+						transpose_micro(x, y);
+					}
+				}
+
+				// right / bottom edges of the tile
+				transpose_scalar(micro_end_x, tile_end_x, tile_y, tile_end_y);
+				transpose_scalar(tile_x, micro_end_x, micro_end_y, tile_end_y);
+			}
+		}
+	}
+
+	export
+	{
+		/**
+		 * @brief dest(y, x) = source(x, y).
+		 * @note dest must be height x width and must not overlap source.
+		 */
+		template<typename T>
+		auto transpose(const std::type_identity_t<PixmapView<const T>> source, PixmapView<T> dest) noexcept -> void
+		{
+			transpose_blocked<false, false>(source, dest);
+		}
+
+		/**
+		 * @brief Transposes a square view in place.
+		 */
+		template<typename T>
+		auto transpose(PixmapView<T> dest) noexcept -> void
+		{
+			GAL_ASSUME(dest.width() == dest.height(), "Only a square pixmap can be transposed in place!");
+
+			constexpr auto tile = transform_tile_size<T>;
+			const auto	   size = dest.width();
+
+			// Swap the tiles above the diagonal with their mirror below the diagonal, pixel by pixel.
+			for (std::size_t tile_y = 0; tile_y < size; tile_y += tile)
+			{
+				const auto tile_end_y = std::ranges::min(tile_y + tile, size);
+
+				for (auto tile_x = tile_y; tile_x < size; tile_x += tile)
+				{
+					const auto tile_end_x = std::ranges::min(tile_x + tile, size);
+
+					for (auto y = tile_y; y < tile_end_y; ++y)
+					{
+						auto row = dest[y];
+						for (auto x = std::ranges::max(tile_x, y + 1); x < tile_end_x; ++x)
+						{
+							using std::swap;
+							swap(row[x], dest.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(y, x));
+						}
+					}
+				}
+			}
+		}
+
+		/**
+		 * @brief Rotates source by 90 degrees clockwise.
+		 * @note dest must be height x width and must not overlap source.
+		 */
+		template<typename T>
+		auto rotate_90(const std::type_identity_t<PixmapView<const T>> source, PixmapView<T> dest) noexcept -> void
+		{
+			transpose_blocked<true, false>(source, dest);
+		}
+
+		/**
+		 * @brief Rotates source by 270 degrees clockwise (90 degrees counterclockwise).
+		 * @note dest must be height x width and must not overlap source.
+		 */
+		template<typename T>
+		auto rotate_270(const std::type_identity_t<PixmapView<const T>> source, PixmapView<T> dest) noexcept -> void
+		{
+			transpose_blocked<false, true>(source, dest);
+		}
+
+		/**
+		 * @brief Mirrors source left to right.
+		 * @note dest must be width x height and must not overlap source.
+		 */
+		template<typename T>
+		constexpr auto flip_horizontal(const std::type_identity_t<PixmapView<const T>> source, PixmapView<T> dest) noexcept -> void
+		{
+			GAL_ASSUME(source.width() == dest.width(), "Width mismatch!");
+			GAL_ASSUME(source.height() == dest.height(), "Height mismatch!");
+
+			for (std::size_t y = 0; y < source.height(); ++y)
+			{
+				std::ranges::reverse_copy(source[y], dest[y].begin());
+			}
+		}
+
+		/**
+		 * @brief Mirrors dest left to right in place.
+		 */
+		template<typename T>
+		constexpr auto flip_horizontal(PixmapView<T> dest) noexcept -> void
+		{
+			for (std::size_t y = 0; y < dest.height(); ++y)
+			{
+				std::ranges::reverse(dest[y]);
+			}
+		}
+
+		/**
+		 * @brief Mirrors source top to bottom.
+		 * @note dest must be width x height and must not overlap source.
+		 */
+		template<typename T>
+		constexpr auto flip_vertical(const std::type_identity_t<PixmapView<const T>> source, PixmapView<T> dest) noexcept -> void
+		{
+			GAL_ASSUME(source.width() == dest.width(), "Width mismatch!");
+			GAL_ASSUME(source.height() == dest.height(), "Height mismatch!");
+
+			const auto height = source.height();
+			for (std::size_t y = 0; y < height; ++y)
+			{
+				std::ranges::copy(source[y], dest[height - 1 - y].begin());
+			}
+		}
+
+		/**
+		 * @brief Mirrors dest top to bottom in place.
+		 */
+		template<typename T>
+		constexpr auto flip_vertical(PixmapView<T> dest) noexcept -> void
+		{
+			const auto height = dest.height();
+			for (std::size_t y = 0; y < height / 2; ++y)
+			{
+				std::ranges::swap_ranges(dest[y], dest[height - 1 - y]);
+			}
+		}
+
+		/**
+		 * @brief Rotates source by 180 degrees.
+		 * @note dest must be width x height and must not overlap source.
+		 */
+		template<typename T>
+		constexpr auto rotate_180(const std::type_identity_t<PixmapView<const T>> source, PixmapView<T> dest) noexcept -> void
+		{
+			GAL_ASSUME(source.width() == dest.width(), "Width mismatch!");
+			GAL_ASSUME(source.height() == dest.height(), "Height mismatch!");
+
+			const auto height = source.height();
+			for (std::size_t y = 0; y < height; ++y)
+			{
+				std::ranges::reverse_copy(source[y], dest[height - 1 - y].begin());
+			}
+		}
+
+		/**
+		 * @brief Rotates dest by 180 degrees in place.
+		 */
+		template<typename T>
+		constexpr auto rotate_180(PixmapView<T> dest) noexcept -> void
+		{
+			const auto height = dest.height();
+			for (std::size_t y = 0; y < height / 2; ++y)
+			{
+				auto top	= dest[y];
+				auto bottom = dest[height - 1 - y];
+
+				std::ranges::swap_ranges(top, bottom);
+				std::ranges::reverse(top);
+				std::ranges::reverse(bottom);
+			}
+
+			if (height % 2 == 1)
+			{
+				std::ranges::reverse(dest[height / 2]);
+			}
+		}
+	}
+}// namespace gal::gui::image
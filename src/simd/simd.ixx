@@ -1,11 +1,141 @@
 module;
 
+#include <eve/module/core.hpp>
 #include <eve/wide.hpp>
 
 export module gal.simd;
 
+import std;
+
 namespace gal::gui::simd
+{
+	template<typename T, typename N, std::size_t... I>
+	[[nodiscard]] auto interleave(const eve::wide<T, N> a, const eve::wide<T, N> b, std::index_sequence<I...>) noexcept -> std::array<eve::wide<T, N>, 2>
+	{
+		constexpr auto size = eve::wide<T, N>::size();
+		constexpr auto half = size / 2;
+
+		const eve::wide<T, eve::fixed<2 * size>> both{a, b};
+		return {
+				both[eve::pattern<(I % 2 == 0 ? static_cast<std::ptrdiff_t>(I / 2) : size + static_cast<std::ptrdiff_t>(I / 2))...>],
+				both[eve::pattern<(I % 2 == 0 ? half + static_cast<std::ptrdiff_t>(I / 2) : size + half + static_cast<std::ptrdiff_t>(I / 2))...>]};
+	}
+
+	template<typename T, typename N, std::size_t... I>
+	[[nodiscard]] auto reverse(const eve::wide<T, N> value, std::index_sequence<I...>) noexcept -> eve::wide<T, N>
+	{
+		return value[eve::pattern<(eve::wide<T, N>::size() - 1 - static_cast<std::ptrdiff_t>(I))...>];
+	}
+}// namespace gal::gui::simd
+
+export namespace gal::gui::simd
 {
 	template<typename T, std::size_t N>
 	using simd = eve::wide<T, eve::fixed<N>>;
+
+	/**
+	 * @brief The types a simd can hold, i.e. the arithmetic types except bool and long double.
+	 */
+	template<typename T>
+	concept lane_type = eve::plain_scalar_value<T>;
+
+	/**
+	 * @brief Loads N consecutive values, source does not have to be aligned.
+	 */
+	template<std::size_t N, lane_type T>
+	[[nodiscard]] auto load(const T* source) noexcept -> simd<T, N>
+	{
+		return simd<T, N>{source};
+	}
+
+	/**
+	 * @brief Stores all lanes of value to consecutive values, dest does not have to be aligned.
+	 */
+	template<typename T, typename N>
+	auto store(const eve::wide<T, N> value, T* dest) noexcept -> void
+	{
+		eve::store(value, dest);
+	}
+
+	/**
+	 * @brief Converts every lane as static_cast would.
+	 */
+	template<lane_type To, typename T, typename N>
+	[[nodiscard]] auto convert(const eve::wide<T, N> value) noexcept -> eve::wide<To, N>
+	{
+		return eve::convert(value, eve::as<To>{});
+	}
+
+	template<typename T, typename N>
+	[[nodiscard]] auto min(const eve::wide<T, N> a, const eve::wide<T, N> b) noexcept -> eve::wide<T, N>
+	{
+		return eve::min(a, b);
+	}
+
+	template<typename T, typename N>
+	[[nodiscard]] auto max(const eve::wide<T, N> a, const eve::wide<T, N> b) noexcept -> eve::wide<T, N>
+	{
+		return eve::max(a, b);
+	}
+
+	/**
+	 * @brief The smallest lane.
+	 */
+	template<typename T, typename N>
+	[[nodiscard]] auto minimum(const eve::wide<T, N> value) noexcept -> T
+	{
+		return eve::minimum(value);
+	}
+
+	/**
+	 * @brief The largest lane.
+	 */
+	template<typename T, typename N>
+	[[nodiscard]] auto maximum(const eve::wide<T, N> value) noexcept -> T
+	{
+		return eve::maximum(value);
+	}
+
+	/**
+	 * @brief The sum of all lanes, in the lane type.
+	 */
+	template<typename T, typename N>
+	[[nodiscard]] auto sum(const eve::wide<T, N> value) noexcept -> T
+	{
+		return eve::reduce(value);
+	}
+
+	/**
+	 * @brief The inclusive prefix sum of the lanes, in log2(size) steps: value += value shifted right by 1, 2, 4... lanes (zeros shifted in).
+	 */
+	template<std::ptrdiff_t Shift = 1, typename T, typename N>
+	[[nodiscard]] auto inclusive_scan(const eve::wide<T, N> value) noexcept -> eve::wide<T, N>
+	{
+		if constexpr (Shift >= eve::wide<T, N>::size())
+		{
+			return value;
+		}
+		else
+		{
+			return inclusive_scan<Shift * 2>(value + eve::slide_right(value, eve::index<Shift>));
+		}
+	}
+
+	/**
+	 * @brief Interleaves the low halves and the high halves of a and b: {a0, b0, a1, b1, ...}, {a(N/2), b(N/2), ...}.
+	 */
+	template<typename T, typename N>
+	[[nodiscard]] auto interleave(const eve::wide<T, N> a, const eve::wide<T, N> b) noexcept -> std::array<eve::wide<T, N>, 2>
+	{
+		return interleave(a, b, std::make_index_sequence<static_cast<std::size_t>(eve::wide<T, N>::size())>{});
+	}
+
+	/**
+	 * @brief The lanes in reverse order.
+	 */
+	template<typename T, typename N>
+	[[nodiscard]] auto reverse(const eve::wide<T, N> value) noexcept -> eve::wide<T, N>
+	{
+		return reverse(value, std::make_index_sequence<static_cast<std::size_t>(eve::wide<T, N>::size())>{});
+	}
 }// namespace gal::gui::simd
@@ -0,0 +1,415 @@
+#include <macro.hpp>
+
+import std;
+import gal.utility;
+import gal.image;
+import gal.test;
+
+namespace
+{
+	/**
+	 * @see main.cpp :)
+	 */
+	using dummy = GAL_TEMPLATE_STRING_TYPE("I don't know why this declaration is required, but without it the compiler will report the above. (Translated from other languages into English, which may not be entirely accurate.)");
+
+	using namespace gal::gui;
+	using namespace gal::gui::test;
+
+	using pipeline_type = image::LoadPipeline<std::uint8_t, std::uint32_t>;
+	using pixmap_type	= pipeline_type::pixmap_type;
+	using decoded_type	= pipeline_type::decoded_pixmap_type;
+	using size_type		= pixmap_type::size_type;
+
+	// A directory of test images, removed at the end of the test.
+	class Corpus
+	{
+		std::filesystem::path directory_;
+
+	public:
+		Corpus(const Corpus&)					 = delete;
+		Corpus(Corpus&&)						 = delete;
+		auto operator=(const Corpus&) -> Corpus& = delete;
+		auto operator=(Corpus&&) -> Corpus&		 = delete;
+
+		explicit Corpus(const std::string_view name)
+			: directory_{std::filesystem::temp_directory_path() / std::format("gal_test_image_loader_{}", name)}
+		{
+			std::filesystem::create_directories(directory_);
+		}
+
+		~Corpus() noexcept
+		{
+			std::error_code error;
+			std::filesystem::remove_all(directory_, error);
+		}
+
+		[[nodiscard]] auto path(const std::string_view name) const -> std::filesystem::path
+		{
+			return directory_ / name;
+		}
+	};
+
+	// Resumed inline by co_await, the exceptions are checked by the tests through the handles.
+	struct DetachedTask
+	{
+		struct promise_type
+		{
+			[[nodiscard]] constexpr auto get_return_object() const noexcept -> DetachedTask { return {}; }
+
+			[[nodiscard]] constexpr auto initial_suspend() const noexcept -> std::suspend_never { return {}; }
+
+			[[nodiscard]] constexpr auto final_suspend() const noexcept -> std::suspend_never { return {}; }
+
+			constexpr auto return_void() const noexcept -> void {}
+
+			[[noreturn]] auto unhandled_exception() const noexcept -> void { std::terminate(); }
+		};
+	};
+
+	// width(u32) height(u32) pixels(u32 * width * height), pixel == x + y * width
+	auto write_image(const std::filesystem::path& path, const std::uint32_t width, const std::uint32_t height) -> void
+	{
+		std::ofstream file{path, std::ios::binary};
+		file.write(reinterpret_cast<const char*>(&width), sizeof(width));
+		file.write(reinterpret_cast<const char*>(&height), sizeof(height));
+		for (std::uint32_t i = 0; i < width * height; ++i)
+		{
+			file.write(reinterpret_cast<const char*>(&i), sizeof(i));
+		}
+	}
+
+	[[nodiscard]] auto decode(const std::span<const std::byte> bytes) -> decoded_type
+	{
+		std::uint32_t width;
+		std::uint32_t height;
+		std::memcpy(&width, bytes.data(), sizeof(width));
+		std::memcpy(&height, bytes.data() + sizeof(width), sizeof(height));
+
+		decoded_type result{width, height};
+		std::memcpy(result.data(), bytes.data() + sizeof(width) + sizeof(height), result.size() * sizeof(std::uint32_t));
+		return result;
+	}
+
+	[[nodiscard]] auto halve(const std::uint32_t& pixel) -> std::uint8_t
+	{
+		return static_cast<std::uint8_t>(pixel / 2);
+	}
+
+	GAL_NO_DESTROY suite test_image_loader = []
+	{
+		"convert"_test = []
+		{
+			const image::Pixmap<std::uint32_t> source{std::array<std::uint32_t, 6>{0, 2, 4, 6, 8, 10}.data(), 3, 2};
+			image::Pixmap<std::uint8_t>		   dest{3, 2};
+
+			image::convert(image::PixmapView<const std::uint32_t>{source}, image::PixmapView<std::uint8_t>{dest}, halve);
+
+			std::uint8_t value{0};
+			for (const auto pixel: dest)
+			{
+				expect((pixel == _ull{value}) >> fatal);
+				++value;
+			}
+		};
+
+		"resize_nearest"_test = []
+		{
+			// 0    1   2   3
+			// 4    5   6   7
+			const image::Pixmap<std::uint8_t> source{std::array<std::uint8_t, 8>{0, 1, 2, 3, 4, 5, 6, 7}.data(), 4, 2};
+			image::Pixmap<std::uint8_t>		  dest{2, 1};
+
+			image::resize_nearest(image::PixmapView<const std::uint8_t>{source}, image::PixmapView<std::uint8_t>{dest});
+
+			expect((dest.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(0, 0) == 0_ull) >> fatal);
+			expect((dest.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(1, 0) == 2_ull) >> fatal);
+		};
+
+		"load"_test = []
+		{
+			const Corpus corpus{"load"};
+			const auto	 path = corpus.path("load");
+			write_image(path, 4, 3);
+
+			pipeline_type pipeline{decode, halve, 1, 1, 4};
+
+			const auto	  pixmap = pipeline.load(path).get();
+
+			expect((pixmap.width() == 4_ull) >> fatal);
+			expect((pixmap.height() == 3_ull) >> fatal);
+			for (size_type i = 0; i < pixmap.size(); ++i)
+			{
+				expect((pixmap.data()[i] == _ull{i / 2}) >> fatal);
+			}
+		};
+
+		"load_and_resize"_test = []
+		{
+			const Corpus corpus{"load_and_resize"};
+			const auto	 path = corpus.path("load_and_resize");
+			write_image(path, 4, 4);
+
+			pipeline_type pipeline{decode, halve, 1, 1, 4};
+
+			const auto	  pixmap = pipeline.load(path, {.priority = image::LoadPriority::high, .width = 2, .height = 2}).get();
+
+			expect((pixmap.width() == 2_ull) >> fatal);
+			expect((pixmap.height() == 2_ull) >> fatal);
+			// source pixel (2, 2) == 10
+			expect((pixmap.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(1, 1) == 5_ull) >> fatal);
+		};
+
+		"load_missing_file"_test = []
+		{
+			const Corpus  corpus{"load_missing_file"};
+			pipeline_type pipeline{decode, halve, 1, 1, 4};
+
+			auto		  handle = pipeline.load(corpus.path("missing"));
+
+			expect((throws<utility::Exception>([&] { (void)handle.get(); })) >> fatal);
+		};
+
+		"then"_test = []
+		{
+			const Corpus corpus{"then"};
+			const auto	 path = corpus.path("then");
+			write_image(path, 5, 1);
+
+			// Declared before the pipeline, the workers may still touch it until they are joined.
+			std::atomic<int> width{0};
+			pipeline_type	 pipeline{decode, halve, 1, 1, 4};
+
+			pipeline.load(path).then(
+					[&width](pipeline_type::result_type result) noexcept
+					{
+						width = static_cast<int>(result->width());
+						width.notify_all();
+					});
+			width.wait(0);
+
+			expect((width.load() == 5_i) >> fatal);
+		};
+
+		"co_await"_test = []
+		{
+			const Corpus corpus{"co_await"};
+			write_image(corpus.path("first"), 3, 1);
+			write_image(corpus.path("second"), 6, 1);
+
+			std::atomic<int> width{0};
+			pipeline_type	 pipeline{decode, halve, 1, 1, 4};
+
+			[](pipeline_type& p, const Corpus& c, std::atomic<int>& result) -> DetachedTask
+			{
+				const auto first  = co_await p.load(c.path("first"));
+				// resumed on a worker, where only async_load / try_load may be used
+				auto	   handle = co_await p.async_load(c.path("second"));
+				const auto second = co_await handle;
+
+				result = static_cast<int>(first.width() + second.width());
+				result.notify_all();
+			}(pipeline, corpus, width);
+			width.wait(0);
+
+			expect((width.load() == 9_i) >> fatal);
+		};
+
+		"backpressure"_test = []
+		{
+			const Corpus corpus{"backpressure"};
+			const auto	 path = corpus.path("backpressure");
+			write_image(path, 2, 2);
+
+			std::latch		  gate{1};
+			std::atomic<bool> blocking{true};
+			std::atomic<int>  waiting{0};
+
+			// The first decoding blocks the only cpu worker, so both slots stay taken until the gate opens.
+			pipeline_type	  pipeline{
+					 [&](const std::span<const std::byte> bytes)
+					 {
+						 if (blocking.exchange(false))
+						 {
+							 gate.wait();
+						 }
+						 return decode(bytes);
+					 },
+					 halve,
+					 1,
+					 1,
+					 2};
+
+			auto first	= pipeline.load(path);
+			auto second = pipeline.load(path);
+
+			expect((not pipeline.try_load(path).has_value()) >> fatal);
+
+			[](pipeline_type& p, const std::filesystem::path& file, std::atomic<int>& result) -> DetachedTask
+			{
+				result		= 1;
+				auto handle = co_await p.async_load(file);
+				result		= 2;
+				(void)co_await handle;
+
+				result = 3;
+				result.notify_all();
+			}(pipeline, path, waiting);
+			expect((waiting.load() == 1_i) >> fatal);
+
+			gate.count_down();
+			expect((first.get().width() == 2_ull) >> fatal);
+			expect((second.get().width() == 2_ull) >> fatal);
+
+			waiting.wait(1);
+			waiting.wait(2);
+			expect((waiting.load() == 3_i) >> fatal);
+
+			// all slots are released before the results are published
+			auto third = pipeline.try_load(path);
+			expect((third.has_value()) >> fatal);
+			expect((third->get().width() == 2_ull) >> fatal);
+		};
+
+		"slot_priority"_test = []
+		{
+			const Corpus corpus{"slot_priority"};
+			const auto	 path = corpus.path("slot_priority");
+			write_image(path, 2, 2);
+
+			constexpr std::array priorities{image::LoadPriority::low, image::LoadPriority::normal, image::LoadPriority::high, image::LoadPriority::normal};
+
+			std::latch			 gate{1};
+			std::atomic<bool>	 blocking{true};
+			std::mutex			 mutex;
+			std::vector<int>	 order;
+			std::atomic<int>	 remaining{4};
+
+			// The first decoding blocks the only cpu worker, so the only slot stays taken until the gate opens.
+			pipeline_type		 pipeline{
+					 [&](const std::span<const std::byte> bytes)
+					 {
+						 if (blocking.exchange(false))
+						 {
+							 gate.wait();
+						 }
+						 return decode(bytes);
+					 },
+					 halve,
+					 1,
+					 1,
+					 1};
+
+			auto first = pipeline.load(path);
+
+			// The slot is handed over to the waiters by priority, then in the order they started waiting.
+			for (int i = 0; i < static_cast<int>(priorities.size()); ++i)
+			{
+				[](pipeline_type& p, const std::filesystem::path& file, const int index, const image::LoadPriority pr, std::mutex& m, std::vector<int>& o, std::atomic<int>& r) -> DetachedTask
+				{
+					auto handle = co_await p.async_load(file, {.priority = pr});
+					{
+						std::scoped_lock lock{m};
+						o.push_back(index);
+					}
+					(void)co_await handle;
+
+					if (r.fetch_sub(1) == 1)
+					{
+						r.notify_all();
+					}
+				}(pipeline, path, i, priorities[i], mutex, order, remaining);
+			}
+
+			gate.count_down();
+			expect((first.get().width() == 2_ull) >> fatal);
+
+			for (auto current = remaining.load(); current != 0; current = remaining.load())
+			{
+				remaining.wait(current);
+			}
+
+			std::scoped_lock lock{mutex};
+			expect((order == std::vector{2, 1, 3, 0}) >> fatal);
+		};
+
+		"priority"_test = []
+		{
+			image::WorkerPool				 pool{1};
+
+			std::latch						 gate{1};
+			std::mutex						 mutex;
+			std::vector<image::LoadPriority> order;
+			std::atomic<int>				 remaining{4};
+
+			// Blocks the only worker, the jobs below are queued before it is released.
+			[](image::WorkerPool& p, std::latch& g) -> DetachedTask
+			{
+				co_await p.schedule();
+				g.wait();
+			}(pool, gate);
+
+			for (const auto priority: {image::LoadPriority::low, image::LoadPriority::normal, image::LoadPriority::high, image::LoadPriority::normal})
+			{
+				[](image::WorkerPool& p, const image::LoadPriority pr, std::mutex& m, std::vector<image::LoadPriority>& o, std::atomic<int>& r) -> DetachedTask
+				{
+					co_await p.schedule(pr);
+					{
+						std::scoped_lock lock{m};
+						o.push_back(pr);
+					}
+					if (r.fetch_sub(1) == 1)
+					{
+						r.notify_all();
+					}
+				}(pool, priority, mutex, order, remaining);
+			}
+			gate.count_down();
+
+			for (auto current = remaining.load(); current != 0; current = remaining.load())
+			{
+				remaining.wait(current);
+			}
+
+			std::scoped_lock lock{mutex};
+			expect((order == std::vector{image::LoadPriority::high, image::LoadPriority::normal, image::LoadPriority::normal, image::LoadPriority::low}) >> fatal);
+		};
+
+		"cancel"_test = []
+		{
+			const Corpus corpus{"cancel"};
+			const auto	 path = corpus.path("cancel");
+			write_image(path, 2, 2);
+
+			std::latch		  gate{1};
+			std::atomic<bool> blocking{true};
+
+			// The first decoding blocks the only cpu worker until the second load is cancelled.
+			pipeline_type	  pipeline{
+					 [&](const std::span<const std::byte> bytes)
+					 {
+						 if (blocking.exchange(false))
+						 {
+							 gate.wait();
+						 }
+						 return decode(bytes);
+					 },
+					 halve,
+					 1,
+					 1,
+					 4};
+
+			auto first = pipeline.load(path);
+			while (blocking)
+			{
+				std::this_thread::yield();
+			}
+
+			auto second = pipeline.load(path);
+			second.cancel();
+			gate.count_down();
+
+			expect((first.get().width() == 2_ull) >> fatal);
+			expect((throws<image::LoadCancelled>([&] { (void)second.get(); })) >> fatal);
+		};
+	};
+}// namespace
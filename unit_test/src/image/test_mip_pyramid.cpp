@@ -0,0 +1,124 @@
+#include <macro.hpp>
+
+import std;
+import gal.utility;
+import gal.image;
+import gal.test;
+
+namespace
+{
+	/**
+	 * @see main.cpp :)
+	 */
+	using dummy = GAL_TEMPLATE_STRING_TYPE("I don't know why this declaration is required, but without it the compiler will report the above. (Translated from other languages into English, which may not be entirely accurate.)");
+
+	using namespace gal::gui;
+	using namespace gal::gui::test;
+
+	using pixmap_type	   = image::Pixmap<std::uint8_t>;
+	using pixmap_view_type = image::PixmapView<std::uint8_t>;
+	using value_type	   = pixmap_type::value_type;
+	using size_type		   = pixmap_type::size_type;
+
+	// odd sizes, every level but the last one repeats its last column / row
+	constexpr size_type pixmap_default_width{37};
+	constexpr size_type pixmap_default_height{21};
+
+	// pixel(x, y) == (x * 5 + y * 11) % 256
+	[[nodiscard]] constexpr auto make_pixmap() -> pixmap_type
+	{
+		pixmap_type result{pixmap_default_width, pixmap_default_height};
+
+		for (size_type y = 0; y < pixmap_default_height; ++y)
+		{
+			for (size_type x = 0; x < pixmap_default_width; ++x)
+			{
+				result.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(x, y) = static_cast<value_type>((x * 5 + y * 11) % 256);
+			}
+		}
+		return result;
+	}
+
+	GAL_NO_DESTROY suite test_image_mip_pyramid = []
+	{
+		"build"_test = []
+		{
+			const auto							pixmap = make_pixmap();
+			const image::MipPyramid<value_type> pyramid{image::PixmapView{pixmap}};
+
+			// 37x21 => 19x11 => 10x6 => 5x3 => 3x2 => 2x1 => 1x1
+			constexpr std::array<std::pair<size_type, size_type>, 7> sizes{{{37, 21}, {19, 11}, {10, 6}, {5, 3}, {3, 2}, {2, 1}, {1, 1}}};
+			expect((pyramid.levels() == _ull{sizes.size()}) >> fatal);
+			for (size_type i = 0; i < sizes.size(); ++i)
+			{
+				expect((pyramid.level(i).width() == _ull{sizes[i].first}) >> fatal);
+				expect((pyramid.level(i).height() == _ull{sizes[i].second}) >> fatal);
+			}
+
+			expect((std::ranges::equal(pyramid.level(0), image::PixmapView{pixmap})) >> fatal);
+
+			// (0 + 5 + 11 + 16 + 2) / 4
+			expect((pyramid.level(1).GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(0, 0) == 8_ull) >> fatal);
+			// the last column of level 0 is repeated: (180 + 180 + 191 + 191 + 2) / 4
+			expect((pyramid.level(1).GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(18, 0) == 186_ull) >> fatal);
+		};
+
+		"signed"_test = []
+		{
+			using signed_type = std::int16_t;
+
+			// Mostly negative pixels, (sum + 2) / 4 truncates toward zero (e.g. a mean of -1.25 became 0 instead of -1).
+			image::Pixmap<signed_type> pixmap{pixmap_default_width, pixmap_default_height};
+			for (size_type y = 0; y < pixmap_default_height; ++y)
+			{
+				for (size_type x = 0; x < pixmap_default_width; ++x)
+				{
+					pixmap.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(x, y) = static_cast<signed_type>(static_cast<int>((x * 5 + y * 11) % 64) - 48);
+				}
+			}
+			const image::MipPyramid<signed_type> pyramid{image::PixmapView{pixmap}};
+
+			for (size_type i = 1; i < pyramid.levels(); ++i)
+			{
+				const auto& source = pyramid.level(i - 1);
+				const auto& level  = pyramid.level(i);
+
+				for (size_type y = 0; y < level.height(); ++y)
+				{
+					for (size_type x = 0; x < level.width(); ++x)
+					{
+						const auto right  = std::ranges::min(2 * x + 1, source.width() - 1);
+						const auto bottom = std::ranges::min(2 * y + 1, source.height() - 1);
+						const auto sum	  = source.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(2 * x, 2 * y) + source.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(right, 2 * y) + source.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(2 * x, bottom) + source.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(right, bottom);
+
+						expect((level.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(x, y) == _i{static_cast<int>(std::floor(sum / 4. + .5))}) >> fatal);
+					}
+				}
+			}
+
+			// (-3 * 4 + 2) / 4 == -2, the mean is exactly -3
+			const image::Pixmap<signed_type>	 constant{std::array<signed_type, 4>{-3, -3, -3, -3}.data(), 2, 2};
+			const image::MipPyramid<signed_type> constant_pyramid{image::PixmapView{constant}};
+			expect((constant_pyramid.level(1).GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(0, 0) == _i{-3}) >> fatal);
+		};
+
+		"update"_test = []
+		{
+			auto						  pixmap = make_pixmap();
+			image::MipPyramid<value_type> pyramid{pixmap};
+
+			auto						  dirty	 = pixmap_view_type{pixmap}.sub_view(13, 5, 9, 7);
+			std::ranges::fill(dirty[0], value_type{255});
+			std::ranges::fill(dirty[6], value_type{0});
+			dirty.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(4, 3) = 42;
+
+			pyramid.update(pixmap, 13, 5, 9, 7);
+
+			const image::MipPyramid<value_type> rebuilt{pixmap};
+			for (size_type i = 0; i < rebuilt.levels(); ++i)
+			{
+				expect((std::ranges::equal(pyramid.level(i), rebuilt.level(i))) >> fatal);
+			}
+		};
+	};
+}// namespace
@@ -0,0 +1,229 @@
+#include <macro.hpp>
+
+import std;
+import gal.utility;
+import gal.image;
+import gal.test;
+
+namespace
+{
+	/**
+	 * @see main.cpp :)
+	 */
+	using dummy = GAL_TEMPLATE_STRING_TYPE("I don't know why this declaration is required, but without it the compiler will report the above. (Translated from other languages into English, which may not be entirely accurate.)");
+
+	using namespace gal::gui;
+	using namespace gal::gui::test;
+
+	using pixmap_type	   = image::Pixmap<std::uint8_t>;
+	using pixmap_view_type = image::PixmapView<std::uint8_t>;
+	using value_type	   = pixmap_type::value_type;
+	using size_type		   = pixmap_type::size_type;
+
+	constexpr float circle_kappa{0.5522847f};
+
+	auto add_rect(image::Path& path, const float left, const float top, const float right, const float bottom) -> void
+	{
+		path.move_to({left, top}).line_to({right, top}).line_to({right, bottom}).line_to({left, bottom}).close();
+	}
+
+	auto add_circle(image::Path& path, const float center_x, const float center_y, const float radius) -> void
+	{
+		const auto k = radius * circle_kappa;
+
+		path.move_to({center_x + radius, center_y});
+		path.cubic_to({center_x + radius, center_y + k}, {center_x + k, center_y + radius}, {center_x, center_y + radius});
+		path.cubic_to({center_x - k, center_y + radius}, {center_x - radius, center_y + k}, {center_x - radius, center_y});
+		path.cubic_to({center_x - radius, center_y - k}, {center_x - k, center_y - radius}, {center_x, center_y - radius});
+		path.cubic_to({center_x + k, center_y - radius}, {center_x + radius, center_y - k}, {center_x + radius, center_y});
+	}
+
+	[[nodiscard]] auto total_coverage(const pixmap_type& pixmap) -> double
+	{
+		return std::reduce(pixmap.begin(), pixmap.end(), 0., [](const double total, const double pixel) { return total + pixel; }) / 255;
+	}
+
+	GAL_NO_DESTROY suite test_image_rasterizer = []
+	{
+		"rect"_test = []
+		{
+			pixmap_type		  pixmap{16, 12};
+
+			image::Path		  path;
+			image::Rasterizer rasterizer;
+
+			add_rect(path, 2, 3, 10, 8);
+			rasterizer.fill(path, pixmap);
+
+			for (size_type y = 0; y < pixmap.height(); ++y)
+			{
+				for (size_type x = 0; x < pixmap.width(); ++x)
+				{
+					const auto inside = x >= 2 and x < 10 and y >= 3 and y < 8;
+					expect((pixmap.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(x, y) == _ull{inside ? 255u : 0u}) >> fatal);
+				}
+			}
+		};
+
+		"partial_coverage"_test = []
+		{
+			pixmap_type		  pixmap{4, 2};
+
+			image::Path		  path;
+			image::Rasterizer rasterizer;
+
+			add_rect(path, .5f, 0, 3.5f, 2);
+			rasterizer.fill(path, pixmap);
+
+			for (size_type y = 0; y < pixmap.height(); ++y)
+			{
+				expect((pixmap.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(0, y) == 128_ull) >> fatal);
+				expect((pixmap.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(1, y) == 255_ull) >> fatal);
+				expect((pixmap.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(2, y) == 255_ull) >> fatal);
+				expect((pixmap.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(3, y) == 128_ull) >> fatal);
+			}
+
+			// composited over the existing coverage: 128 + 0.5 * (255 - 128)
+			rasterizer.fill(path, pixmap);
+			expect((pixmap.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(0, 0) == 192_ull) >> fatal);
+			expect((pixmap.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(1, 0) == 255_ull) >> fatal);
+
+			// a triangle covering half of every pixel of the diagonal
+			pixmap_type triangle{4, 4};
+			path.clear();
+			path.move_to({0, 0}).line_to({4, 4}).line_to({0, 4});
+			rasterizer.fill(path, triangle);
+
+			for (size_type y = 0; y < triangle.height(); ++y)
+			{
+				for (size_type x = 0; x < triangle.width(); ++x)
+				{
+					const auto expected = x == y ? 128u : (x < y ? 255u : 0u);
+					expect((triangle.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(x, y) == _ull{expected}) >> fatal);
+				}
+			}
+		};
+
+		"fill_rule"_test = []
+		{
+			image::Path		  path;
+			image::Rasterizer rasterizer;
+
+			// two squares in the same direction
+			add_rect(path, 0, 0, 8, 8);
+			add_rect(path, 2, 2, 6, 6);
+
+			pixmap_type nonzero{8, 8};
+			pixmap_type even_odd{8, 8};
+			rasterizer.fill(path, nonzero, image::FillRule::nonzero);
+			rasterizer.fill(path, even_odd, image::FillRule::even_odd);
+
+			for (size_type y = 0; y < 8; ++y)
+			{
+				for (size_type x = 0; x < 8; ++x)
+				{
+					const auto hole = x >= 2 and x < 6 and y >= 2 and y < 6;
+					expect((nonzero.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(x, y) == 255_ull) >> fatal);
+					expect((even_odd.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(x, y) == _ull{hole ? 0u : 255u}) >> fatal);
+				}
+			}
+
+			// the inner square in the opposite direction is a hole for nonzero too
+			path.clear();
+			add_rect(path, 0, 0, 8, 8);
+			path.move_to({2, 2}).line_to({2, 6}).line_to({6, 6}).line_to({6, 2});
+
+			pixmap_type reversed{8, 8};
+			rasterizer.fill(path, reversed, image::FillRule::nonzero);
+			expect((reversed == even_odd) >> fatal);
+		};
+
+		"curves"_test = []
+		{
+			image::Path		  path;
+			image::Rasterizer rasterizer;
+
+			pixmap_type		  circle{32, 32};
+			add_circle(path, 16, 16, 10);
+			rasterizer.fill(path, circle);
+
+			// flattening into chords loses at most the tolerance (0.1 pixel) times the perimeter
+			expect((total_coverage(circle) > std::numbers::pi * 100 - 0.1 * 2 * std::numbers::pi * 10) >> fatal);
+			expect((total_coverage(circle) < 1.001 * std::numbers::pi * 100) >> fatal);
+			for (size_type y = 0; y < circle.height(); ++y)
+			{
+				for (size_type x = 0; x < circle.width(); ++x)
+				{
+					const auto pixel	= circle.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(x, y);
+					const auto mirrored = circle.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(31 - x, y);
+					expect((std::max(pixel, mirrored) - std::min(pixel, mirrored) <= 1_i) >> fatal);
+				}
+			}
+
+			// the area under a parabola is 2/3 of its bounding box
+			pixmap_type parabola{32, 16};
+			path.clear();
+			path.move_to({0, 0}).quad_to({16, 32}, {32, 0});
+			rasterizer.fill(path, parabola);
+
+			expect((total_coverage(parabola) > 0.99 * (2. / 3 * 32 * 16)) >> fatal);
+			expect((total_coverage(parabola) < 1.001 * (2. / 3 * 32 * 16)) >> fatal);
+		};
+
+		"clip_and_sub_view"_test = []
+		{
+			pixmap_type		  pixmap{20, 20};
+			const auto		  view = pixmap_view_type{pixmap}.sub_view(5, 5, 10, 10);
+
+			image::Path		  path;
+			image::Rasterizer rasterizer;
+
+			// the coordinates are relative to the view, and the path goes past its top left corner
+			add_rect(path, -5, -5, 3, 3);
+			rasterizer.fill(path, view);
+
+			for (size_type y = 0; y < pixmap.height(); ++y)
+			{
+				for (size_type x = 0; x < pixmap.width(); ++x)
+				{
+					const auto inside = x >= 5 and x < 8 and y >= 5 and y < 8;
+					expect((pixmap.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(x, y) == _ull{inside ? 255u : 0u}) >> fatal);
+				}
+			}
+
+			// past the bottom right corner, and entirely outside
+			path.clear();
+			add_rect(path, 8, 8, 30, 30);
+			add_rect(path, -20, 2, -10, 4);
+			rasterizer.fill(path, view);
+
+			expect((pixmap.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(13, 13) == 255_ull) >> fatal);
+			expect((pixmap.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(14, 14) == 255_ull) >> fatal);
+			expect((pixmap.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(15, 15) == 0_ull) >> fatal);
+			expect((pixmap.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(5, 8) == 0_ull) >> fatal);
+		};
+
+		"scratch_reuse"_test = []
+		{
+			image::Path		  path;
+			image::Rasterizer rasterizer;
+
+			// a large path first, then a smaller one reusing (and relying on the cleared) scratch buffer
+			pixmap_type		  large{300, 20};
+			add_circle(path, 150, 10, 140);
+			rasterizer.fill(path, large);
+
+			path.clear();
+			add_circle(path, 6, 6, 5);
+
+			pixmap_type first{12, 12};
+			rasterizer.fill(path, first);
+
+			image::Rasterizer fresh;
+			pixmap_type		  second{12, 12};
+			fresh.fill(path, second);
+
+			expect((first == second) >> fatal);
+		};
+	};
+}// namespace
@@ -0,0 +1,203 @@
+#include <macro.hpp>
+
+import std;
+import gal.utility;
+import gal.image;
+import gal.test;
+
+namespace
+{
+	/**
+	 * @see main.cpp :)
+	 */
+	using dummy = GAL_TEMPLATE_STRING_TYPE("I don't know why this declaration is required, but without it the compiler will report the above. (Translated from other languages into English, which may not be entirely accurate.)");
+
+	using namespace gal::gui;
+	using namespace gal::gui::test;
+
+	using pixmap_type	   = image::Pixmap<std::uint8_t>;
+	using pixmap_view_type = image::PixmapView<std::uint8_t>;
+	using value_type	   = pixmap_type::value_type;
+	using size_type		   = pixmap_type::size_type;
+
+	constexpr size_type pixmap_default_width{100};
+	constexpr size_type pixmap_default_height{30};
+
+	// pixel(x, y) == (x + y * 3) % 251
+	[[nodiscard]] constexpr auto make_pixmap() -> pixmap_type
+	{
+		pixmap_type result{pixmap_default_width, pixmap_default_height};
+
+		for (size_type y = 0; y < pixmap_default_height; ++y)
+		{
+			for (size_type x = 0; x < pixmap_default_width; ++x)
+			{
+				result.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(x, y) = static_cast<value_type>((x + y * 3) % 251);
+			}
+		}
+		return result;
+	}
+
+	// value / 4 for floating point pixels (so that the sums stay exact), value * 1000 for 32-bit ones
+	template<typename T>
+	[[nodiscard]] constexpr auto make_pixel(const int value) -> T
+	{
+		if constexpr (std::is_floating_point_v<T>)
+		{
+			return static_cast<T>(value) / 4;
+		}
+		else
+		{
+			return static_cast<T>(value * (sizeof(T) == 4 ? 1000 : 1));
+		}
+	}
+
+	// A view wider than one block of every lane count (but not a multiple of any), with a stride of its own, so that both the simd blocks and the scalar tail of each row are reduced.
+	template<typename T>
+	auto check_reduction() -> void
+	{
+		constexpr size_type width  = 101;
+		constexpr size_type height = 7;
+
+		// -100 .. 99 for signed pixels, 1 .. 200 otherwise
+		constexpr int		low	   = std::is_signed_v<T> ? -100 : 1;
+
+		image::Pixmap<T>	pixmap{width + 6, height + 2};
+		for (size_type y = 0; y < pixmap.height(); ++y)
+		{
+			for (size_type x = 0; x < pixmap.width(); ++x)
+			{
+				pixmap.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(x, y) = make_pixel<T>(low + static_cast<int>((x * 7 + y * 13) % 200));
+			}
+		}
+
+		auto view = image::PixmapView<T>{pixmap}.sub_view(3, 1, width, height);
+		// the minimum in the scalar tail of a row, the maximum in its first block
+		view.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(width - 1, 2)  = make_pixel<T>(low - 1);
+		view.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(1, height - 1) = make_pixel<T>(1000);
+		// outside of the view
+		pixmap.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(width + 4, 3) = make_pixel<T>(2000);
+
+		using sum_type = decltype(image::sum(view));
+
+		sum_type expected_sum{0};
+		for (const auto row: view.rows())
+		{
+			expected_sum = std::reduce(row.begin(), row.end(), expected_sum);
+		}
+
+		for (const size_type threads: {1, 3})
+		{
+			const auto [min, max] = image::minmax(view, threads);
+
+			expect((_t<T>{min} == _t<T>{make_pixel<T>(low - 1)}) >> fatal);
+			expect((_t<T>{max} == _t<T>{make_pixel<T>(1000)}) >> fatal);
+			expect((_t<sum_type>{image::sum(view, threads)} == _t<sum_type>{expected_sum}) >> fatal);
+		}
+	}
+
+	GAL_NO_DESTROY suite test_image_reduction = []
+	{
+		"minmax"_test = []
+		{
+			auto pixmap = make_pixmap();
+			// 1 .. 99 + 3 * 9
+			auto view	= pixmap_view_type{pixmap}.sub_view(1, 0, 99, 10);
+
+			for (const size_type threads: {1, 3})
+			{
+				const auto [min, max] = image::minmax(view, threads);
+
+				expect((min == 1_ull) >> fatal);
+				expect((max == 126_ull) >> fatal);
+			}
+		};
+
+		"sum_and_mean"_test = []
+		{
+			auto			   pixmap = make_pixmap();
+			const auto		   view	  = pixmap_view_type{pixmap}.sub_view(3, 2, 50, 20);
+
+			unsigned long long expected{0};
+			for (const auto row: view.rows())
+			{
+				expected = std::reduce(row.begin(), row.end(), expected);
+			}
+
+			for (const size_type threads: {1, 4})
+			{
+				expect((image::sum(view, threads) == _ull{expected}) >> fatal);
+				expect((image::mean(view, threads) == _d{static_cast<double>(expected) / static_cast<double>(view.size())}) >> fatal);
+			}
+		};
+
+		"pixel_types"_test = []
+		{
+			check_reduction<std::uint16_t>();
+			check_reduction<std::int16_t>();
+			check_reduction<std::int32_t>();
+			check_reduction<float>();
+			check_reduction<double>();
+		};
+
+		"histogram"_test = []
+		{
+			auto							  pixmap = make_pixmap();
+			const auto						  view	 = pixmap_view_type{pixmap}.sub_view(0, 1, 60, 25);
+
+			std::array<size_type, 256>		  expected{};
+			for (const auto row: view.rows())
+			{
+				for (const auto pixel: row)
+				{
+					++expected[pixel];
+				}
+			}
+
+			for (const size_type threads: {1, 5})
+			{
+				const auto histogram = image::histogram(view, threads);
+				for (size_type i = 0; i < expected.size(); ++i)
+				{
+					expect((histogram[i] == _ull{expected[i]}) >> fatal);
+				}
+
+				const auto coarse = image::histogram<2>(view, [](const value_type pixel) { return pixel < 128 ? 0 : 1; }, threads);
+				expect((coarse[0] + coarse[1] == _ull{view.size()}) >> fatal);
+				expect((coarse[0] == _ull{std::reduce(expected.begin(), expected.begin() + 128, size_type{0})}) >> fatal);
+			}
+		};
+
+		"opaque_bounds"_test = []
+		{
+			pixmap_type pixmap{pixmap_default_width, pixmap_default_height};
+
+			for (const size_type threads: {1, 4})
+			{
+				expect((image::opaque_bounds(pixmap_view_type{pixmap}, threads).empty() == "empty"_b) >> fatal);
+			}
+
+			pixmap.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(70, 3)  = 1;
+			pixmap.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(5, 17)  = 255;
+			pixmap.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(40, 21) = 42;
+
+			for (const size_type threads: {1, 4})
+			{
+				const auto bounds = image::opaque_bounds(pixmap_view_type{pixmap}, threads);
+
+				expect((bounds.x == 5_ull) >> fatal);
+				expect((bounds.y == 3_ull) >> fatal);
+				expect((bounds.width == 66_ull) >> fatal);
+				expect((bounds.height == 19_ull) >> fatal);
+			}
+
+			// only the pixels above the threshold are opaque
+			const auto bounds = image::opaque_bounds(pixmap_view_type{pixmap}, [](const value_type pixel) { return pixel > 10; });
+
+			expect((bounds.x == 5_ull) >> fatal);
+			expect((bounds.y == 17_ull) >> fatal);
+			expect((bounds.width == 36_ull) >> fatal);
+			expect((bounds.height == 5_ull) >> fatal);
+		};
+	};
+}// namespace
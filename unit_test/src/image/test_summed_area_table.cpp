@@ -0,0 +1,171 @@
+#include <macro.hpp>
+
+import std;
+import gal.utility;
+import gal.image;
+import gal.test;
+
+namespace
+{
+	/**
+	 * @see main.cpp :)
+	 */
+	using dummy = GAL_TEMPLATE_STRING_TYPE("I don't know why this declaration is required, but without it the compiler will report the above. (Translated from other languages into English, which may not be entirely accurate.)");
+
+	using namespace gal::gui;
+	using namespace gal::gui::test;
+
+	using pixmap_type	   = image::Pixmap<std::uint8_t>;
+	using pixmap_view_type = image::PixmapView<std::uint8_t>;
+	using value_type	   = pixmap_type::value_type;
+	using size_type		   = pixmap_type::size_type;
+
+	constexpr size_type pixmap_default_width{60};
+	constexpr size_type pixmap_default_height{40};
+
+	// pixel(x, y) == (x * 7 + y * 13) % 256
+	[[nodiscard]] constexpr auto make_pixmap() -> pixmap_type
+	{
+		pixmap_type result{pixmap_default_width, pixmap_default_height};
+
+		for (size_type y = 0; y < pixmap_default_height; ++y)
+		{
+			for (size_type x = 0; x < pixmap_default_width; ++x)
+			{
+				result.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(x, y) = static_cast<value_type>((x * 7 + y * 13) % 256);
+			}
+		}
+		return result;
+	}
+
+	[[nodiscard]] auto naive_sum(const pixmap_type& pixmap, const size_type x, const size_type y, const size_type width, const size_type height) -> unsigned long long
+	{
+		unsigned long long result{0};
+		for (auto j = y; j < y + height; ++j)
+		{
+			for (auto i = x; i < x + width; ++i)
+			{
+				result += pixmap.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(i, j);
+			}
+		}
+		return result;
+	}
+
+	// Updates rectangles starting at odd columns of a strided view, so that the simd blocks of build_from begin at misaligned addresses and every row ends with a scalar tail.
+	// The pixels are multiples of 0.25 for floating point tables, the sums are exact in any order.
+	template<typename T>
+	auto check_update(const T scale) -> void
+	{
+		using table_type = image::SummedAreaTable<T>;
+		using sum_type	 = typename table_type::accumulator_type;
+
+		image::Pixmap<T> pixmap{75, 33};
+		for (size_type y = 0; y < pixmap.height(); ++y)
+		{
+			for (size_type x = 0; x < pixmap.width(); ++x)
+			{
+				pixmap.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(x, y) = static_cast<T>(static_cast<T>(static_cast<int>((x * 7 + y * 13) % 600) - 300) * scale);
+			}
+		}
+		auto	   view		 = image::PixmapView<T>{pixmap}.sub_view(2, 1, 70, 30);
+
+		const auto naive_sum = [view](const size_type x, const size_type y, const size_type width, const size_type height) -> sum_type
+		{
+			sum_type result{0};
+			for (auto j = y; j < y + height; ++j)
+			{
+				for (auto i = x; i < x + width; ++i)
+				{
+					result += static_cast<sum_type>(view.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(i, j));
+				}
+			}
+			return result;
+		};
+
+		table_type table{view};
+		expect((_t<sum_type>{table.sum()} == _t<sum_type>{naive_sum(0, 0, 70, 30)}) >> fatal);
+
+		for (const auto [x, y, width, height]: {
+					 std::array<size_type, 4>{13, 5, 17, 9},
+					 std::array<size_type, 4>{1, 0, 3, 30},
+					 std::array<size_type, 4>{33, 11, 37, 2},
+					 std::array<size_type, 4>{69, 29, 1, 1}})
+		{
+			for (auto j = y; j < y + height; ++j)
+			{
+				for (auto i = x; i < x + width; ++i)
+				{
+					view.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(i, j) = static_cast<T>(static_cast<T>(static_cast<int>(i + j) % 50 - 30) * scale);
+				}
+			}
+			table.update(view, x, y, width, height);
+
+			const table_type rebuilt{view};
+			expect((std::ranges::equal(table.table(), rebuilt.table())) >> fatal);
+			expect((_t<sum_type>{table.sum(x, y, width, height)} == _t<sum_type>{naive_sum(x, y, width, height)}) >> fatal);
+			expect((_t<sum_type>{table.sum(7, 3, 51, 26)} == _t<sum_type>{naive_sum(7, 3, 51, 26)}) >> fatal);
+		}
+	}
+
+	GAL_NO_DESTROY suite test_image_summed_area_table = []
+	{
+		"sum"_test = []
+		{
+			const auto								 pixmap = make_pixmap();
+			const image::SummedAreaTable<value_type> table{image::PixmapView{pixmap}};
+
+			expect((table.width() == _ull{pixmap_default_width}) >> fatal);
+			expect((table.height() == _ull{pixmap_default_height}) >> fatal);
+			expect((table.sum() == _ull{naive_sum(pixmap, 0, 0, pixmap_default_width, pixmap_default_height)}) >> fatal);
+
+			for (const auto [x, y, width, height]: {
+						 std::array<size_type, 4>{0, 0, 1, 1},
+						 std::array<size_type, 4>{0, 0, pixmap_default_width, 1},
+						 std::array<size_type, 4>{5, 3, 20, 17},
+						 std::array<size_type, 4>{59, 39, 1, 1},
+						 std::array<size_type, 4>{10, 10, 0, 5}})
+			{
+				expect((table.sum(x, y, width, height) == _ull{naive_sum(pixmap, x, y, width, height)}) >> fatal);
+			}
+
+			expect((table.mean(5, 3, 20, 17) == _d{static_cast<double>(naive_sum(pixmap, 5, 3, 20, 17)) / (20 * 17)}) >> fatal);
+			expect((table.mean(5, 3, 0, 17) == 0_d) >> fatal);
+		};
+
+		"sub_view"_test = []
+		{
+			auto									 pixmap = make_pixmap();
+			const auto								 view	= pixmap_view_type{pixmap}.sub_view(7, 4, 30, 20);
+
+			const image::SummedAreaTable<value_type> table{view};
+
+			expect((table.sum() == _ull{naive_sum(pixmap, 7, 4, 30, 20)}) >> fatal);
+			expect((table.sum(3, 2, 10, 10) == _ull{naive_sum(pixmap, 10, 6, 10, 10)}) >> fatal);
+		};
+
+		"update"_test = []
+		{
+			auto							   pixmap = make_pixmap();
+			image::SummedAreaTable<value_type> table{pixmap};
+
+			for (size_type y = 12; y < 20; ++y)
+			{
+				for (size_type x = 30; x < 45; ++x)
+				{
+					pixmap.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(x, y) = 255;
+				}
+			}
+			table.update(pixmap, 30, 12, 15, 8);
+
+			const image::SummedAreaTable<value_type> rebuilt{pixmap};
+			expect((std::ranges::equal(table.table(), rebuilt.table())) >> fatal);
+			expect((table.sum(25, 10, 30, 15) == _ull{naive_sum(pixmap, 25, 10, 30, 15)}) >> fatal);
+		};
+
+		"pixel_types"_test = []
+		{
+			check_update<std::int16_t>(7);
+			check_update<float>(.25f);
+		};
+	};
+}// namespace
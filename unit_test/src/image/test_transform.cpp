@@ -0,0 +1,201 @@
+#include <macro.hpp>
+
+import std;
+import gal.utility;
+import gal.image;
+import gal.test;
+
+namespace
+{
+	/**
+	 * @see main.cpp :)
+	 */
+	using dummy = GAL_TEMPLATE_STRING_TYPE("I don't know why this declaration is required, but without it the compiler will report the above. (Translated from other languages into English, which may not be entirely accurate.)");
+
+	using namespace gal::gui;
+	using namespace gal::gui::test;
+
+	using pixmap_type	   = image::Pixmap<std::uint32_t>;
+	using pixmap_view_type = image::PixmapView<std::uint32_t>;
+	using value_type	   = pixmap_type::value_type;
+	using size_type		   = pixmap_type::size_type;
+
+	// Large enough to span several tiles and to leave partial micro tiles on the edges.
+	constexpr size_type pixmap_default_width{77};
+	constexpr size_type pixmap_default_height{45};
+
+	// pixel(x, y) == x + y * width
+	[[nodiscard]] constexpr auto make_pixmap(const size_type width = pixmap_default_width, const size_type height = pixmap_default_height) -> pixmap_type
+	{
+		pixmap_type result{width, height};
+
+		value_type	value{0};
+		for (auto& pixel: result)
+		{
+			pixel = value++;
+		}
+		return result;
+	}
+
+	[[nodiscard]] constexpr auto pixel_of(const size_type x, const size_type y, const size_type width = pixmap_default_width) -> unsigned long long
+	{
+		return x + y * width;
+	}
+
+	// Transposes / rotates a width x height view with a stride of another pixel format, the 8-bit pixels wrap around.
+	template<typename T>
+	auto check_transpose(const size_type width, const size_type height) -> void
+	{
+		constexpr size_type padding = 3;
+
+		image::Pixmap<T>	source{width + padding, height + 1};
+		for (size_type i = 0; i < source.size(); ++i)
+		{
+			source.data()[i] = static_cast<T>(i);
+		}
+		const auto		 view = image::PixmapView<const T>{image::PixmapView<T>{source}.sub_view(2, 1, width, height)};
+
+		image::Pixmap<T> transposed{height, width};
+		image::Pixmap<T> rotated_90{height, width};
+		image::Pixmap<T> rotated_270{height, width};
+		image::transpose(view, image::PixmapView<T>{transposed});
+		image::rotate_90(view, image::PixmapView<T>{rotated_90});
+		image::rotate_270(view, image::PixmapView<T>{rotated_270});
+
+		for (size_type y = 0; y < height; ++y)
+		{
+			for (size_type x = 0; x < width; ++x)
+			{
+				const auto expected = static_cast<unsigned long long>(static_cast<T>(pixel_of(x + 2, y + 1, width + padding)));
+				expect((transposed.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(y, x) == _ull{expected}) >> fatal);
+				expect((rotated_90.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(height - 1 - y, x) == _ull{expected}) >> fatal);
+				expect((rotated_270.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(y, width - 1 - x) == _ull{expected}) >> fatal);
+			}
+		}
+	}
+
+	GAL_NO_DESTROY suite test_image_transform = []
+	{
+		"transpose"_test = []
+		{
+			const auto	source = make_pixmap();
+			pixmap_type dest{pixmap_default_height, pixmap_default_width};
+
+			image::transpose(source, pixmap_view_type{dest});
+
+			for (size_type y = 0; y < pixmap_default_height; ++y)
+			{
+				for (size_type x = 0; x < pixmap_default_width; ++x)
+				{
+					expect((dest.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(y, x) == _ull{pixel_of(x, y)}) >> fatal);
+				}
+			}
+		};
+
+		"transpose_in_place"_test = []
+		{
+			auto pixmap = make_pixmap(pixmap_default_width, pixmap_default_width);
+
+			// square sub view with a stride
+			auto view	= pixmap_view_type{pixmap}.sub_view(3, 2, 70, 70);
+			image::transpose(view);
+
+			for (size_type y = 0; y < view.height(); ++y)
+			{
+				for (size_type x = 0; x < view.width(); ++x)
+				{
+					expect((view.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(y, x) == _ull{pixel_of(x + 3, y + 2)}) >> fatal);
+				}
+			}
+		};
+
+		"rotate_90"_test = []
+		{
+			const auto	source = make_pixmap();
+			pixmap_type dest{pixmap_default_height, pixmap_default_width};
+
+			image::rotate_90(source, pixmap_view_type{dest});
+
+			for (size_type y = 0; y < pixmap_default_height; ++y)
+			{
+				for (size_type x = 0; x < pixmap_default_width; ++x)
+				{
+					expect((dest.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(pixmap_default_height - 1 - y, x) == _ull{pixel_of(x, y)}) >> fatal);
+				}
+			}
+		};
+
+		"rotate_270"_test = []
+		{
+			const auto	source = make_pixmap();
+			pixmap_type dest{pixmap_default_height, pixmap_default_width};
+
+			image::rotate_270(source, pixmap_view_type{dest});
+
+			for (size_type y = 0; y < pixmap_default_height; ++y)
+			{
+				for (size_type x = 0; x < pixmap_default_width; ++x)
+				{
+					expect((dest.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(y, pixmap_default_width - 1 - x) == _ull{pixel_of(x, y)}) >> fatal);
+				}
+			}
+		};
+
+		"pixel_sizes"_test = []
+		{
+			// 8x8 micro tiles for 1/2-byte pixels and 4x4 ones for 8-byte pixels, none of the sizes is a multiple of the micro / tile size.
+			for (const auto [width, height]: {std::pair<size_type, size_type>{77, 45}, {45, 77}, {35, 13}, {5, 3}})
+			{
+				check_transpose<std::uint8_t>(width, height);
+				check_transpose<std::uint16_t>(width, height);
+				check_transpose<std::uint64_t>(width, height);
+			}
+		};
+
+		"rotate_180"_test = []
+		{
+			const auto	source = make_pixmap();
+			pixmap_type dest{pixmap_default_width, pixmap_default_height};
+
+			image::rotate_180(source, pixmap_view_type{dest});
+
+			auto in_place = make_pixmap();
+			image::rotate_180(pixmap_view_type{in_place});
+
+			expect((dest == in_place) >> fatal);
+			for (size_type y = 0; y < pixmap_default_height; ++y)
+			{
+				for (size_type x = 0; x < pixmap_default_width; ++x)
+				{
+					expect((dest.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(pixmap_default_width - 1 - x, pixmap_default_height - 1 - y) == _ull{pixel_of(x, y)}) >> fatal);
+				}
+			}
+		};
+
+		"flip"_test = []
+		{
+			const auto	source = make_pixmap();
+			pixmap_type horizontal{pixmap_default_width, pixmap_default_height};
+			pixmap_type vertical{pixmap_default_width, pixmap_default_height};
+
+			image::flip_horizontal(source, pixmap_view_type{horizontal});
+			image::flip_vertical(source, pixmap_view_type{vertical});
+
+			for (size_type y = 0; y < pixmap_default_height; ++y)
+			{
+				for (size_type x = 0; x < pixmap_default_width; ++x)
+				{
+					expect((horizontal.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(pixmap_default_width - 1 - x, y) == _ull{pixel_of(x, y)}) >> fatal);
+					expect((vertical.GAL_ARR_SUBSCRIPT_OPERATOR_WORKAROUND_OPERATOR(x, pixmap_default_height - 1 - y) == _ull{pixel_of(x, y)}) >> fatal);
+				}
+			}
+
+			// flipping twice in place restores the source
+			image::flip_horizontal(pixmap_view_type{horizontal});
+			image::flip_vertical(pixmap_view_type{vertical});
+
+			expect((horizontal == source) >> fatal);
+			expect((vertical == source) >> fatal);
+		};
+	};
+}// namespace